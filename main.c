@@ -4,7 +4,24 @@
 #include <climits>
 #include <string>
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <atomic>
+#include <thread>
+#include <chrono>
 #include <termios.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 static struct termios settings;
 
@@ -117,7 +134,113 @@ int rangeInput(int x, int y, int from, int to, bool echo)
     return value;
 }
 
-bool isNegativeMap[] = {
+// Fixed-width integers wider than the 64-bit types; limbs are stored least
+// significant first. Arithmetic is done by the limbs* helpers below, which
+// take the limb count at run time so one copy serves every width, and
+// every operation wraps modulo 2^bits.
+template <int bits, bool isSigned>
+struct WideInteger
+{
+    unsigned long long limbs[bits / 64];
+};
+
+template <int bits>
+using WideUint = WideInteger<bits, false>;
+
+template <int bits>
+using WideInt = WideInteger<bits, true>;
+
+// Carry chain for value = value * multiplier + addend; returns the limb
+// that falls off the top.
+constexpr unsigned long long limbsMulAdd(unsigned long long limbs[], int count, unsigned long long multiplier, unsigned long long addend)
+{
+    unsigned long long carry = addend;
+    for (int i = 0; i < count; i++)
+    {
+        unsigned __int128 product = (unsigned __int128)limbs[i] * multiplier + carry;
+        limbs[i] = (unsigned long long)product;
+        carry = (unsigned long long)(product >> 64);
+    }
+    return carry;
+}
+
+// Divides in place by a single-limb divisor and returns the remainder.
+unsigned long long limbsDivide(unsigned long long limbs[], int count, unsigned long long divisor)
+{
+    unsigned __int128 remainder = 0;
+    for (int i = count - 1; i >= 0; i--)
+    {
+        unsigned __int128 dividend = (remainder << 64) | limbs[i];
+        limbs[i] = (unsigned long long)(dividend / divisor);
+        remainder = dividend % divisor;
+    }
+    return (unsigned long long)remainder;
+}
+
+constexpr void limbsNegate(unsigned long long limbs[], int count)
+{
+    unsigned long long carry = 1;
+    for (int i = 0; i < count; i++)
+    {
+        limbs[i] = ~limbs[i] + carry;
+        carry = carry != 0 && limbs[i] == 0 ? 1 : 0;
+    }
+}
+
+constexpr bool limbsIsZero(const unsigned long long limbs[], int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (limbs[i] != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const int invalidDigit = 36;
+
+// Digit decoding shared by the runtime parsers and the constant parser below.
+constexpr int digitValue(char symbol)
+{
+    if (symbol >= '0' && symbol <= '9')
+    {
+        return symbol - '0';
+    }
+    if (symbol >= 'A' && symbol <= 'Z')
+    {
+        return symbol - 'A' + 10;
+    }
+    if (symbol >= 'a' && symbol <= 'z')
+    {
+        return symbol - 'a' + 10;
+    }
+    return invalidDigit;
+}
+
+constexpr bool isFractionPoint(char symbol)
+{
+    return symbol == '.' || symbol == ',';
+}
+
+// One step of the approximate value kept by parseExact and the floating
+// point constants; scale is the weight of the last fraction digit.
+constexpr long double accumulateApproximate(long double value, long double *scale, bool isFraction, int radix, int digit)
+{
+    if (!isFraction)
+    {
+        return value * radix + digit;
+    }
+    *scale /= radix;
+    return value + digit * *scale;
+}
+
+const int wideLimbsMax = 1024 / 64;
+const int decimalCapacity = 320;
+const int binaryCapacity = 1288;
+
+constexpr bool isNegativeMap[] = {
         false, // char
         true,  // signed char
         true,  // short
@@ -143,6 +266,12 @@ bool isNegativeMap[] = {
         false, // unsigned long long int
         true,  // float
         true,  // double
+        true,  // int256
+        false, // uint256
+        true,  // int512
+        false, // uint512
+        true,  // int1024
+        false, // uint1024
 };
 
 bool isFloatMap[] = {
@@ -171,6 +300,12 @@ bool isFloatMap[] = {
         false, // unsigned long long int
         true,  // float
         true,  // double
+        false, // int256
+        false, // uint256
+        false, // int512
+        false, // uint512
+        false, // int1024
+        false, // uint1024
 };
 
 std::string dataTypeNames[] = {
@@ -199,9 +334,15 @@ std::string dataTypeNames[] = {
         "unsigned long long int",
         "float",
         "double",
+        "int256",
+        "uint256",
+        "int512",
+        "uint512",
+        "int1024",
+        "uint1024",
 };
 
-short varSize[] = {
+constexpr short varSize[] = {
         sizeof(char),
         sizeof(signed char),
         sizeof(short),
@@ -227,538 +368,2670 @@ short varSize[] = {
         sizeof(unsigned long long int),
         sizeof(float),
         sizeof(double),
+        sizeof(WideInt<256>),
+        sizeof(WideUint<256>),
+        sizeof(WideInt<512>),
+        sizeof(WideUint<512>),
+        sizeof(WideInt<1024>),
+        sizeof(WideUint<1024>),
 };
 
-short dataTypeIndex = 0;
-
-bool mayBeNegative = true;
-bool mayBeFloat = true;
-
-short base = 10;
-char input[10000] = {'\0'};
-bool isNegative = false;
+const short dataTypeCount = sizeof(varSize) / sizeof(varSize[0]);
 
-int inputLength = 0;
-int step = 0;
-bool isInputValid = false;
+// Table index of each C++ type the constants can be evaluated as; types
+// the table spells several ways map to their first entry.
+template <typename T>
+constexpr short dataTypeIndexOf = -1;
+template <>
+constexpr short dataTypeIndexOf<char> = 0;
+template <>
+constexpr short dataTypeIndexOf<signed char> = 1;
+template <>
+constexpr short dataTypeIndexOf<short> = 2;
+template <>
+constexpr short dataTypeIndexOf<unsigned short> = 6;
+template <>
+constexpr short dataTypeIndexOf<int> = 8;
+template <>
+constexpr short dataTypeIndexOf<unsigned int> = 10;
+template <>
+constexpr short dataTypeIndexOf<long> = 11;
+template <>
+constexpr short dataTypeIndexOf<unsigned long> = 15;
+template <>
+constexpr short dataTypeIndexOf<long long> = 17;
+template <>
+constexpr short dataTypeIndexOf<unsigned long long> = 21;
+template <>
+constexpr short dataTypeIndexOf<float> = 23;
+template <>
+constexpr short dataTypeIndexOf<double> = 24;
+template <>
+constexpr short dataTypeIndexOf<WideInt<256>> = 25;
+template <>
+constexpr short dataTypeIndexOf<WideUint<256>> = 26;
+template <>
+constexpr short dataTypeIndexOf<WideInt<512>> = 27;
+template <>
+constexpr short dataTypeIndexOf<WideUint<512>> = 28;
+template <>
+constexpr short dataTypeIndexOf<WideInt<1024>> = 29;
+template <>
+constexpr short dataTypeIndexOf<WideUint<1024>> = 30;
 
-void extractMantissa(const char src[], char dist[], int *mantissa)
+// Whether a magnitude and sign convert to an integer type of at most 64
+// bits without wrapping; shared by narrowValue and the radix constants.
+constexpr bool narrowFits(unsigned long long magnitude, bool negative, short typeIndex)
 {
-    int length = 0;
-    int srcLength = 0;
-    int mantissaIndexFromStart = -1;
-    for (int i = 0; *(src + i) != '\0'; i++)
+    int width = varSize[typeIndex] * CHAR_BIT;
+    unsigned long long mask = width >= 64 ? ULLONG_MAX : (1ULL << width) - 1;
+    unsigned long long limit = isNegativeMap[typeIndex] ? mask >> 1 : mask;
+    if (negative && isNegativeMap[typeIndex])
     {
-        if (*(src + i) == '.')
-        {
-            mantissaIndexFromStart = i + 1;
-        }
-        if (*(src + i) != '-' && *(src + i) != '.')
-        {
-            *(dist + length) = *(src + i);
-            *(dist + length + 1) = '\0';
-            length++;
-        }
-        srcLength++;
+        limit++;
     }
-    if (mantissaIndexFromStart != -1)
+    if (negative && !isNegativeMap[typeIndex] && magnitude != 0)
     {
-        *mantissa = srcLength - mantissaIndexFromStart;
+        return false;
     }
+    return magnitude <= limit;
 }
 
-void changeRadix(char messySrc[], char decimalDest[], char binaryDest[])
+// Splits an optional leading '-' and checks every digit against the radix;
+// returns the index of the first digit.
+constexpr std::size_t radixConstantStart(const char digits[], std::size_t length, int radix, bool *negative)
 {
-    int mantissa = 0;
-    char src[10000] = {'\0'};
-    extractMantissa(messySrc, src, &mantissa);
-    int length = 0;
-
-    for (int i = 0; *(src + i) != '\0'; i++)
+    if (radix < 2 || radix > 36)
     {
-
-        int one = 1;
-        __asm__(
-        "add %0, %1\n\t"
-        : "+r"(one), "+r"(length));
-    }
-
-    union {
-        char type0;
-        signed char type1;
-        short type2;
-        short int type3;
-        signed short type4;
-        signed short int type5;
-        unsigned short type6;
-        unsigned short int type7;
-        int type8;
-        signed int type9;
-        unsigned int type10;
-        long type11;
-        long int type12;
-        signed long type13;
-        signed long int type14;
-        unsigned long type15;
-        unsigned long int type16;
-        long long type17;
-        long long int type18;
-        signed long long type19;
-        signed long long int type20;
-        unsigned long long type21;
-        unsigned long long int type22;
-        float type23;
-        double type24;
-        unsigned long long int sys;
-    } decimalValue;
-
-    decimalValue.type0 = 0;
-    decimalValue.type1 = 0;
-    decimalValue.type2 = 0;
-    decimalValue.type3 = 0;
-    decimalValue.type4 = 0;
-    decimalValue.type5 = 0;
-    decimalValue.type6 = 0;
-    decimalValue.type7 = 0;
-    decimalValue.type8 = 0;
-    decimalValue.type9 = 0;
-    decimalValue.type10 = 0;
-    decimalValue.type11 = 0;
-    decimalValue.type12 = 0;
-    decimalValue.type13 = 0;
-    decimalValue.type14 = 0;
-    decimalValue.type15 = 0;
-    decimalValue.type16 = 0;
-    decimalValue.type17 = 0;
-    decimalValue.type18 = 0;
-    decimalValue.type19 = 0;
-    decimalValue.type20 = 0;
-    decimalValue.type21 = 0;
-    decimalValue.type22 = 0;
-    decimalValue.type23 = 0;
-    decimalValue.type24 = 0;
-    decimalValue.sys = 0;
-
-    for (int i = 0; i < length; i++)
-    {
-        int symbolValue = 0;
-        // Compare *srcstr with ASCII values
-        if (*(src + i) >= '0' && *(src + i) <= '9') // is *srcstr Between 0-9
-        {
-            symbolValue = (((int)(*(src + i))) - '0');
-        }
-        else if ((*(src + i) >= 'A' && *(src + i) <= 'Z')) // is *srcstr Between A-Z
-        {
-            symbolValue = (((int)(*(src + i))) - 'A' + 10);
-        }
-        else if (*(src + i) >= 'a' && *(src + i) <= 'z') // is *srcstr Between a-z
-        {
-            symbolValue = (((int)(*(src + i))) - 'a' + 10);
-        }
-
-        long double addedValue = 0;
-
-        if (i <= length - mantissa)
-        {
-            addedValue = symbolValue * pow(base, length - i - 1 - mantissa);
-        }
-        else
-        {
-            addedValue = symbolValue / pow(base, i);
-        }
-        if (dataTypeIndex == 0)
-        {
-            decimalValue.type0 = isNegative ? (decimalValue.type0 - addedValue) : (decimalValue.type0 + addedValue);
-        }
-        else if (dataTypeIndex == 1)
-        {
-            decimalValue.type1 = isNegative ? (decimalValue.type1 - addedValue) : (decimalValue.type1 + addedValue);
-        }
-        else if (dataTypeIndex == 2)
-        {
-            decimalValue.type2 = isNegative ? (decimalValue.type2 - addedValue) : (decimalValue.type2 + addedValue);
-        }
-        else if (dataTypeIndex == 3)
-        {
-            decimalValue.type3 = isNegative ? (decimalValue.type3 - addedValue) : (decimalValue.type3 + addedValue);
-        }
-        else if (dataTypeIndex == 4)
-        {
-            decimalValue.type4 = isNegative ? (decimalValue.type4 - addedValue) : (decimalValue.type4 + addedValue);
-        }
-        else if (dataTypeIndex == 5)
-        {
-            decimalValue.type5 = isNegative ? (decimalValue.type5 - addedValue) : (decimalValue.type5 + addedValue);
-        }
-        else if (dataTypeIndex == 6)
-        {
-            decimalValue.type6 = isNegative ? (decimalValue.type6 - addedValue) : (decimalValue.type6 + addedValue);
-        }
-        else if (dataTypeIndex == 7)
-        {
-            decimalValue.type7 = isNegative ? (decimalValue.type7 - addedValue) : (decimalValue.type7 + addedValue);
-        }
-        else if (dataTypeIndex == 8)
-        {
-            decimalValue.type8 = isNegative ? (decimalValue.type8 - addedValue) : (decimalValue.type8 + addedValue);
-        }
-        else if (dataTypeIndex == 9)
+        throw std::invalid_argument("radix constant base must be 2-36");
+    }
+    *negative = length > 0 && digits[0] == '-';
+    std::size_t start = *negative ? 1 : 0;
+    if (start == length)
+    {
+        throw std::invalid_argument("radix constant has no digits");
+    }
+    for (std::size_t i = start; i < length; i++)
+    {
+        if (!isFractionPoint(digits[i]) && digitValue(digits[i]) >= radix)
         {
-            decimalValue.type9 = isNegative ? (decimalValue.type9 - addedValue) : (decimalValue.type9 + addedValue);
+            throw std::invalid_argument("radix constant has a digit outside its base");
         }
-        else if (dataTypeIndex == 10)
+    }
+    return start;
+}
+
+// Evaluates a digit string in any base as T. In a constant expression a
+// bad digit or an out-of-range value fails compilation at the throw; at
+// run time the same checks throw std::invalid_argument/std::out_of_range.
+// Signedness and range come from the data type tables, so an integer
+// constant is accepted exactly when narrowValue would convert it without a
+// flag. Floating point constants round like narrowValue does and are only
+// rejected where it would report inf.
+template <typename T, bool isFloat = std::is_floating_point<T>::value>
+struct RadixConstant
+{
+    static_assert(dataTypeIndexOf<T> >= 0, "radix constants need a type from the data type table");
+
+    static constexpr T parse(const char digits[], std::size_t length, int radix)
+    {
+        bool negative = false;
+        std::size_t start = radixConstantStart(digits, length, radix, &negative);
+        unsigned long long magnitude[1] = {0};
+        for (std::size_t i = start; i < length; i++)
         {
-            decimalValue.type10 = isNegative ? (decimalValue.type10 - addedValue) : (decimalValue.type10 + addedValue);
+            if (isFractionPoint(digits[i]))
+            {
+                throw std::invalid_argument("radix constant for an integer type has a fraction");
+            }
+            if (limbsMulAdd(magnitude, 1, radix, digitValue(digits[i])) != 0)
+            {
+                throw std::out_of_range("radix constant overflows its type");
+            }
         }
-        else if (dataTypeIndex == 11)
+
+        if (negative && !isNegativeMap[dataTypeIndexOf<T>] && magnitude[0] != 0)
         {
-            decimalValue.type11 = isNegative ? (decimalValue.type11 - addedValue) : (decimalValue.type11 + addedValue);
+            throw std::out_of_range("radix constant for an unsigned type is negative");
         }
-        else if (dataTypeIndex == 12)
+        if (!narrowFits(magnitude[0], negative, dataTypeIndexOf<T>))
         {
-            decimalValue.type12 = isNegative ? (decimalValue.type12 - addedValue) : (decimalValue.type12 + addedValue);
+            throw std::out_of_range("radix constant overflows its type");
         }
-        else if (dataTypeIndex == 13)
+        if (negative && magnitude[0] != 0)
         {
-            decimalValue.type13 = isNegative ? (decimalValue.type13 - addedValue) : (decimalValue.type13 + addedValue);
+            return (T)(-(T)(magnitude[0] - 1) - 1);
         }
-        else if (dataTypeIndex == 14)
+        return (T)magnitude[0];
+    }
+};
+
+template <typename T>
+struct RadixConstant<T, true>
+{
+    static_assert(dataTypeIndexOf<T> >= 0, "radix constants need a type from the data type table");
+
+    static constexpr T parse(const char digits[], std::size_t length, int radix)
+    {
+        bool negative = false;
+        std::size_t start = radixConstantStart(digits, length, radix, &negative);
+        long double value = 0;
+        long double scale = 1;
+        bool afterDelimeter = false;
+        for (std::size_t i = start; i < length; i++)
         {
-            decimalValue.type14 = isNegative ? (decimalValue.type14 - addedValue) : (decimalValue.type14 + addedValue);
+            if (isFractionPoint(digits[i]) && afterDelimeter)
+            {
+                throw std::invalid_argument("radix constant has two fraction points");
+            }
+            if (isFractionPoint(digits[i]))
+            {
+                afterDelimeter = true;
+                continue;
+            }
+            value = accumulateApproximate(value, &scale, afterDelimeter, radix, digitValue(digits[i]));
         }
-        else if (dataTypeIndex == 15)
+        // Rounding to nearest gives inf from half an ulp above the maximum;
+        // max / (2 - epsilon) is the power of two whose ulp epsilon scales.
+        long double halfUlp = std::numeric_limits<T>::max() / (2 - std::numeric_limits<T>::epsilon())
+                              * std::numeric_limits<T>::epsilon() / 2;
+        if (value >= (long double)std::numeric_limits<T>::max() + halfUlp)
         {
-            decimalValue.type15 = isNegative ? (decimalValue.type15 - addedValue) : (decimalValue.type15 + addedValue);
+            throw std::out_of_range("radix constant overflows its type");
         }
-        else if (dataTypeIndex == 16)
+        return (T)(negative ? -value : value);
+    }
+};
+
+template <int bits, bool isSigned>
+struct RadixConstant<WideInteger<bits, isSigned>, false>
+{
+    static_assert(dataTypeIndexOf<WideInteger<bits, isSigned>> >= 0, "radix constants need a type from the data type table");
+
+    static constexpr WideInteger<bits, isSigned> parse(const char digits[], std::size_t length, int radix)
+    {
+        constexpr bool isSignedType = isNegativeMap[dataTypeIndexOf<WideInteger<bits, isSigned>>];
+        bool negative = false;
+        std::size_t start = radixConstantStart(digits, length, radix, &negative);
+        WideInteger<bits, isSigned> value{};
+        for (std::size_t i = start; i < length; i++)
         {
-            decimalValue.type16 = isNegative ? (decimalValue.type16 - addedValue) : (decimalValue.type16 + addedValue);
+            if (isFractionPoint(digits[i]))
+            {
+                throw std::invalid_argument("radix constant for an integer type has a fraction");
+            }
+            if (limbsMulAdd(value.limbs, bits / 64, radix, digitValue(digits[i])) != 0)
+            {
+                throw std::out_of_range("radix constant overflows its type");
+            }
         }
-        else if (dataTypeIndex == 17)
+
+        bool isZero = limbsIsZero(value.limbs, bits / 64);
+        if (negative && !isSignedType && !isZero)
         {
-            decimalValue.type17 = isNegative ? (decimalValue.type17 - addedValue) : (decimalValue.type17 + addedValue);
+            throw std::out_of_range("radix constant for an unsigned type is negative");
         }
-        else if (dataTypeIndex == 18)
+        if (isSignedType && (value.limbs[bits / 64 - 1] >> 63) != 0)
         {
-            decimalValue.type18 = isNegative ? (decimalValue.type18 - addedValue) : (decimalValue.type18 + addedValue);
+            bool isMinimum = value.limbs[bits / 64 - 1] == (1ULL << 63) && limbsIsZero(value.limbs, bits / 64 - 1);
+            if (!negative || !isMinimum)
+            {
+                throw std::out_of_range("radix constant overflows its type");
+            }
         }
-        else if (dataTypeIndex == 19)
+        if (negative)
         {
-            decimalValue.type19 = isNegative ? (decimalValue.type19 - addedValue) : (decimalValue.type19 + addedValue);
+            limbsNegate(value.limbs, bits / 64);
         }
-        else if (dataTypeIndex == 20)
+        return value;
+    }
+};
+
+template <typename T, std::size_t size>
+constexpr T radixConstant(const char (&digits)[size], int radix)
+{
+    return RadixConstant<T>::parse(digits, size - 1, radix);
+}
+
+constexpr unsigned long long operator"" _b2(const char *digits, std::size_t length)
+{
+    return RadixConstant<unsigned long long>::parse(digits, length, 2);
+}
+
+constexpr unsigned long long operator"" _b8(const char *digits, std::size_t length)
+{
+    return RadixConstant<unsigned long long>::parse(digits, length, 8);
+}
+
+constexpr unsigned long long operator"" _b16(const char *digits, std::size_t length)
+{
+    return RadixConstant<unsigned long long>::parse(digits, length, 16);
+}
+
+constexpr unsigned long long operator"" _b36(const char *digits, std::size_t length)
+{
+    return RadixConstant<unsigned long long>::parse(digits, length, 36);
+}
+
+static_assert("zz"_b36 == 1295, "base 36 constants must match the runtime parser");
+static_assert("3w5e11264sgsf"_b36 == ULLONG_MAX, "the largest base 36 constant must fit");
+static_assert(radixConstant<signed char>("-80", 16) == -128, "signed minimum must be reachable");
+static_assert(radixConstant<double>("1.1", 2) == 1.5, "fractions must follow the base");
+static_assert(radixConstant<float>("0,8", 16) == 0.5f, "',' must mark the fraction like in the runtime parser");
+static_assert(radixConstant<float>("ffffff7", 16) == 0xffffff0p0f, "floats must round like narrowValue");
+static_assert(radixConstant<char>("ff", 16) == (char)255, "char follows the table and is unsigned");
+static_assert(radixConstant<WideUint<256>>("10000000000000000", 16).limbs[1] == 1, "wide constants must carry");
+static_assert(radixConstant<WideInt<256>>("-1", 10).limbs[3] == ULLONG_MAX, "wide constants must wrap negatives");
+
+short dataTypeIndex = 0;
+
+bool mayBeNegative = true;
+bool mayBeFloat = true;
+
+short base = 10;
+char input[10000] = {'\0'};
+bool isNegative = false;
+
+int inputLength = 0;
+int step = 0;
+bool isInputValid = false;
+
+// Only the first magnitudeLimbs limbs of magnitude are meaningful; the rest
+// are left uninitialized so short numbers stay cheap to parse.
+struct ExactValue
+{
+    WideUint<1024> magnitude;
+    int magnitudeLimbs;
+    bool exceedsMagnitude;
+    bool isNegative;
+    bool hasFraction;
+    long double approximate;
+};
+
+enum NarrowFlags
+{
+    NARROW_WRAPPED = 1,
+    NARROW_TRUNCATED = 2,
+    NARROW_ROUNDED = 4,
+    NARROW_OVERFLOWED = 8,
+};
+
+// Typed bits, rendered as text on demand. Types up to 64 bits keep them
+// inline in word; wider types keep width / 64 limbs, least significant
+// first, in storage the holder of the bits provides through limbs.
+struct PackedBits
+{
+    unsigned long long word;
+    unsigned long long *limbs;
+    short width;
+};
+
+const unsigned long long *packedWords(const PackedBits *bits)
+{
+    return bits->width > 64 ? bits->limbs : &bits->word;
+}
+
+enum BitsView
+{
+    BITS_PLAIN,
+    BITS_NIBBLES,
+    BITS_HEX,
+};
+
+BitsView binaryView = BITS_PLAIN;
+
+struct NarrowResult
+{
+    PackedBits bits;
+    int flags;
+};
+
+bool parseExact(const char src[], short radix, bool negative, ExactValue *value);
+void narrowValue(const ExactValue *value, short typeIndex, NarrowResult *result);
+void formatNarrowed(short typeIndex, const NarrowResult *result, char decimalDest[]);
+
+// Every data type goes through the same exact parse and narrowing as the
+// all-types table and the headless modes, so the screens cannot disagree.
+void changeRadix(char messySrc[], char decimalDest[], PackedBits *binaryDest)
+{
+    ExactValue value;
+    NarrowResult result;
+    result.bits.limbs = binaryDest->limbs;
+    parseExact(messySrc, base, isNegative, &value);
+    narrowValue(&value, dataTypeIndex, &result);
+    formatNarrowed(dataTypeIndex, &result, decimalDest);
+    *binaryDest = result.bits;
+}
+
+// Parses the digit string once; magnitude keeps the exact low 1024 bits of
+// the integer part, which is all that two's complement narrowing needs.
+bool parseExact(const char src[], short radix, bool negative, ExactValue *value)
+{
+    value->magnitude.limbs[0] = 0;
+    value->magnitudeLimbs = 1;
+    value->exceedsMagnitude = false;
+    value->isNegative = negative;
+    value->hasFraction = false;
+    value->approximate = 0;
+
+    bool afterDelimeter = false;
+    bool hasDigits = false;
+    long double scale = 1;
+    for (int i = 0; *(src + i) != '\0'; i++)
+    {
+        char symbol = *(src + i);
+        if (symbol == '-' && i == 0)
         {
-            decimalValue.type20 = isNegative ? (decimalValue.type20 - addedValue) : (decimalValue.type20 + addedValue);
+            value->isNegative = !value->isNegative;
+            continue;
         }
-        else if (dataTypeIndex == 21)
+        if (isFractionPoint(symbol) && !afterDelimeter)
         {
-            decimalValue.type21 = isNegative ? (decimalValue.type21 - addedValue) : (decimalValue.type21 + addedValue);
+            afterDelimeter = true;
+            continue;
         }
-        else if (dataTypeIndex == 22)
+
+        int symbolValue = digitValue(symbol);
+        if (symbolValue >= radix)
         {
-            decimalValue.type22 = isNegative ? (decimalValue.type22 - addedValue) : (decimalValue.type22 + addedValue);
+            return false;
         }
-        else if (dataTypeIndex == 23)
+        hasDigits = true;
+
+        value->approximate = accumulateApproximate(value->approximate, &scale, afterDelimeter, radix, symbolValue);
+        if (afterDelimeter)
         {
-            decimalValue.type23 = isNegative ? (decimalValue.type23 - addedValue) : (decimalValue.type23 + addedValue);
+            if (symbolValue != 0)
+            {
+                value->hasFraction = true;
+            }
         }
-        else if (dataTypeIndex == 24)
+        else
         {
-            decimalValue.type24 = isNegative ? (decimalValue.type24 - addedValue) : (decimalValue.type24 + addedValue);
+            unsigned long long carry = limbsMulAdd(value->magnitude.limbs, value->magnitudeLimbs, radix, symbolValue);
+            if (carry != 0 && value->magnitudeLimbs < wideLimbsMax)
+            {
+                value->magnitude.limbs[value->magnitudeLimbs++] = carry;
+            }
+            else if (carry != 0)
+            {
+                value->exceedsMagnitude = true;
+            }
         }
     }
+    return hasDigits;
+}
 
+const int parseLaneCount = 8;
+const int laneDigitsCapacity = 24;
+const int shortLaneCount = 16;
+const int shortDigitsCapacity = 16;
 
-    std::stringstream ioStream;
-
-    ioStream.precision(16);
+typedef unsigned long long LaneVector __attribute__((vector_size(parseLaneCount * sizeof(unsigned long long))));
+typedef unsigned char LaneBytes __attribute__((vector_size(parseLaneCount)));
+typedef unsigned int ShortLaneVector __attribute__((vector_size(shortLaneCount * sizeof(unsigned int))));
+typedef unsigned char ShortLaneBytes __attribute__((vector_size(shortLaneCount)));
 
-    if (dataTypeIndex == 0)
-    {
-        ioStream << decimalValue.sys << ':' << decimalValue.type0;
-    }
-    else if (dataTypeIndex == 1)
-    {
-        ioStream << decimalValue.sys << ':' << decimalValue.type1;
-    }
-    else if (dataTypeIndex == 2)
-    {
-        ioStream << decimalValue.type2;
-    }
-    else if (dataTypeIndex == 3)
-    {
-        ioStream << decimalValue.type3;
-    }
-    else if (dataTypeIndex == 4)
-    {
-        ioStream << decimalValue.type4;
-    }
-    else if (dataTypeIndex == 5)
+// Decodes one transposed column per step for all lanes at once; numbers are
+// right-aligned and padded with '0', so shorter lanes just accumulate zeros.
+// Digits are decoded on bytes and only widened for the multiply-accumulate.
+// A lane is flagged as overflowing as soon as it reaches 2^58, since up to
+// that point value * 36 + 35 still fits 64 bits.
+static inline __attribute__((always_inline))
+void parseLaneKernelBody(const unsigned char columns[], int columnCount, const LaneBytes *radixes,
+                         LaneVector *magnitude, LaneBytes *invalid, LaneVector *overflow)
+{
+    LaneBytes radix = *radixes;
+    LaneVector wideRadix = __builtin_convertvector(radix, LaneVector);
+    LaneVector accumulated = {0};
+    LaneBytes badSymbol = {0};
+    LaneVector wrapped = {0};
+    for (int i = 0; i < columnCount; i++)
     {
-        ioStream << decimalValue.type5;
+        LaneBytes symbol;
+        memcpy(&symbol, columns + i * parseLaneCount, sizeof(symbol));
+        LaneBytes decimalDigit = symbol - '0';
+        LaneBytes upperDigit = symbol - 'A';
+        LaneBytes lowerDigit = symbol - 'a';
+        LaneBytes digit = decimalDigit < 10 ? decimalDigit
+                : upperDigit < 26 ? (LaneBytes)(upperDigit + 10)
+                : lowerDigit < 26 ? (LaneBytes)(lowerDigit + 10)
+                : radix;
+        badSymbol |= (LaneBytes)(digit >= radix);
+
+        wrapped |= accumulated >> 58;
+        accumulated = accumulated * wideRadix + __builtin_convertvector(digit, LaneVector);
     }
-    else if (dataTypeIndex == 6)
+    *magnitude = accumulated;
+    *invalid = badSymbol;
+    *overflow = wrapped;
+}
+
+// Longest digit count per radix whose every value fits 32 bits.
+struct ShortLaneDigitsTable
+{
+    int digits[37];
+
+    constexpr ShortLaneDigitsTable() : digits()
     {
-        ioStream << decimalValue.type6;
+        for (int radix = 2; radix <= 36; radix++)
+        {
+            unsigned long long limit = radix;
+            while (digits[radix] < shortDigitsCapacity && limit <= 1ULL << 32)
+            {
+                digits[radix]++;
+                limit *= radix;
+            }
+        }
     }
-    else if (dataTypeIndex == 7)
+};
+
+constexpr ShortLaneDigitsTable shortLaneDigits;
+
+static_assert(shortLaneDigits.digits[10] == 9 && shortLaneDigits.digits[36] == 6, "short lanes must not overflow 32 bits");
+
+// Same decoding for numbers that fit 32 bits by their digit count, twice
+// the lanes at 32 bits each: 32-bit multiplies are native from SSE4.1 on
+// while 64-bit ones need AVX-512DQ, so no overflow tracking is needed.
+static inline __attribute__((always_inline))
+void parseShortLaneKernelBody(const unsigned char columns[], int columnCount, const ShortLaneBytes *radixes,
+                              ShortLaneVector *magnitude, ShortLaneBytes *invalid)
+{
+    ShortLaneBytes radix = *radixes;
+    ShortLaneVector wideRadix = __builtin_convertvector(radix, ShortLaneVector);
+    ShortLaneVector accumulated = {0};
+    ShortLaneBytes badSymbol = {0};
+    for (int i = 0; i < columnCount; i++)
     {
-        ioStream << decimalValue.type7;
+        ShortLaneBytes symbol;
+        memcpy(&symbol, columns + i * shortLaneCount, sizeof(symbol));
+        ShortLaneBytes decimalDigit = symbol - '0';
+        ShortLaneBytes upperDigit = symbol - 'A';
+        ShortLaneBytes lowerDigit = symbol - 'a';
+        ShortLaneBytes digit = decimalDigit < 10 ? decimalDigit
+                : upperDigit < 26 ? (ShortLaneBytes)(upperDigit + 10)
+                : lowerDigit < 26 ? (ShortLaneBytes)(lowerDigit + 10)
+                : radix;
+        badSymbol |= (ShortLaneBytes)(digit >= radix);
+        accumulated = accumulated * wideRadix + __builtin_convertvector(digit, ShortLaneVector);
     }
-    else if (dataTypeIndex == 8)
+    *magnitude = accumulated;
+    *invalid = badSymbol;
+}
+
+// Expands one limb into 64 '0'/'1' characters, most significant bit first:
+// each lane spreads one byte over eight bytes, keeps one bit per byte and
+// turns it into a character without branches.
+static inline __attribute__((always_inline))
+void expandLimbBody(unsigned long long limb, char dest[])
+{
+    LaneVector spread;
+    for (int i = 0; i < parseLaneCount; i++)
     {
-        ioStream << decimalValue.type8;
+        spread[i] = (limb >> ((parseLaneCount - 1 - i) * CHAR_BIT)) & 0xFF;
     }
-    else if (dataTypeIndex == 9)
+    spread = (spread * 0x0101010101010101ULL) & 0x0102040810204080ULL;
+    spread = (((spread + 0x7F7F7F7F7F7F7F7FULL) & 0x8080808080808080ULL) >> 7) + 0x3030303030303030ULL;
+    memcpy(dest, &spread, sizeof(spread));
+}
+
+void parseLaneKernelBaseline(const unsigned char columns[], int columnCount, const LaneBytes *radixes,
+                             LaneVector *magnitude, LaneBytes *invalid, LaneVector *overflow)
+{
+    parseLaneKernelBody(columns, columnCount, radixes, magnitude, invalid, overflow);
+}
+
+__attribute__((target("sse4.2")))
+void parseLaneKernelSse42(const unsigned char columns[], int columnCount, const LaneBytes *radixes,
+                          LaneVector *magnitude, LaneBytes *invalid, LaneVector *overflow)
+{
+    parseLaneKernelBody(columns, columnCount, radixes, magnitude, invalid, overflow);
+}
+
+__attribute__((target("avx2")))
+void parseLaneKernelAvx2(const unsigned char columns[], int columnCount, const LaneBytes *radixes,
+                         LaneVector *magnitude, LaneBytes *invalid, LaneVector *overflow)
+{
+    parseLaneKernelBody(columns, columnCount, radixes, magnitude, invalid, overflow);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+void parseLaneKernelAvx512(const unsigned char columns[], int columnCount, const LaneBytes *radixes,
+                           LaneVector *magnitude, LaneBytes *invalid, LaneVector *overflow)
+{
+    parseLaneKernelBody(columns, columnCount, radixes, magnitude, invalid, overflow);
+}
+
+void parseShortLaneKernelBaseline(const unsigned char columns[], int columnCount, const ShortLaneBytes *radixes,
+                                  ShortLaneVector *magnitude, ShortLaneBytes *invalid)
+{
+    parseShortLaneKernelBody(columns, columnCount, radixes, magnitude, invalid);
+}
+
+__attribute__((target("sse4.2")))
+void parseShortLaneKernelSse42(const unsigned char columns[], int columnCount, const ShortLaneBytes *radixes,
+                               ShortLaneVector *magnitude, ShortLaneBytes *invalid)
+{
+    parseShortLaneKernelBody(columns, columnCount, radixes, magnitude, invalid);
+}
+
+__attribute__((target("avx2")))
+void parseShortLaneKernelAvx2(const unsigned char columns[], int columnCount, const ShortLaneBytes *radixes,
+                              ShortLaneVector *magnitude, ShortLaneBytes *invalid)
+{
+    parseShortLaneKernelBody(columns, columnCount, radixes, magnitude, invalid);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+void parseShortLaneKernelAvx512(const unsigned char columns[], int columnCount, const ShortLaneBytes *radixes,
+                                ShortLaneVector *magnitude, ShortLaneBytes *invalid)
+{
+    parseShortLaneKernelBody(columns, columnCount, radixes, magnitude, invalid);
+}
+
+void expandLimbBaseline(unsigned long long limb, char dest[])
+{
+    expandLimbBody(limb, dest);
+}
+
+__attribute__((target("sse4.2")))
+void expandLimbSse42(unsigned long long limb, char dest[])
+{
+    expandLimbBody(limb, dest);
+}
+
+__attribute__((target("avx2")))
+void expandLimbAvx2(unsigned long long limb, char dest[])
+{
+    expandLimbBody(limb, dest);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+void expandLimbAvx512(unsigned long long limb, char dest[])
+{
+    expandLimbBody(limb, dest);
+}
+
+// __builtin_cpu_supports only takes literal feature names, so each variant
+// carries its own check.
+bool supportsAvx512()
+{
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+            && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+}
+
+bool supportsAvx2()
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+bool supportsSse42()
+{
+    return __builtin_cpu_supports("sse4.2");
+}
+
+bool supportsBaseline()
+{
+    return true;
+}
+
+struct ConversionKernels
+{
+    const char *name;
+    bool (*isSupported)();
+    void (*parseLanes)(const unsigned char columns[], int columnCount, const LaneBytes *radixes,
+                       LaneVector *magnitude, LaneBytes *invalid, LaneVector *overflow);
+    void (*parseShortLanes)(const unsigned char columns[], int columnCount, const ShortLaneBytes *radixes,
+                            ShortLaneVector *magnitude, ShortLaneBytes *invalid);
+    void (*expandLimb)(unsigned long long limb, char dest[]);
+};
+
+// Ordered from the most to the least demanding instruction set.
+const ConversionKernels kernelVariants[] = {
+        {"avx512", supportsAvx512, parseLaneKernelAvx512, parseShortLaneKernelAvx512, expandLimbAvx512},
+        {"avx2", supportsAvx2, parseLaneKernelAvx2, parseShortLaneKernelAvx2, expandLimbAvx2},
+        {"sse4.2", supportsSse42, parseLaneKernelSse42, parseShortLaneKernelSse42, expandLimbSse42},
+        {"baseline", supportsBaseline, parseLaneKernelBaseline, parseShortLaneKernelBaseline, expandLimbBaseline},
+};
+
+const int kernelVariantCount = sizeof(kernelVariants) / sizeof(kernelVariants[0]);
+
+const ConversionKernels *kernels = &kernelVariants[kernelVariantCount - 1];
+
+bool isKernelSupported(const ConversionKernels *variant)
+{
+    __builtin_cpu_init();
+    return variant->isSupported();
+}
+
+// Picks the kernels once at startup: the named variant if one is forced,
+// otherwise the most capable variant this CPU supports.
+bool selectKernels(const char forced[])
+{
+    for (int i = 0; i < kernelVariantCount; i++)
+    {
+        const ConversionKernels *variant = &kernelVariants[i];
+        if (forced != NULL && strcmp(forced, variant->name) != 0)
+        {
+            continue;
+        }
+        if (isKernelSupported(variant))
+        {
+            kernels = variant;
+            return true;
+        }
+        if (forced != NULL)
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+// Eight '0'/'1' characters for every byte value, most significant bit first.
+struct ByteExpansionTable
+{
+    char bits[256][8];
+
+    constexpr ByteExpansionTable() : bits()
+    {
+        for (int value = 0; value < 256; value++)
+        {
+            for (int bit = 0; bit < 8; bit++)
+            {
+                bits[value][bit] = ((value >> (7 - bit)) & 0x1) == 1 ? '1' : '0';
+            }
+        }
+    }
+};
+
+constexpr ByteExpansionTable byteExpansion;
+
+// Renders packed bits as plain bits, bits grouped by nibble, or hex digits;
+// returns the text length.
+int renderBits(const PackedBits *bits, BitsView view, char dest[])
+{
+    const unsigned long long *words = packedWords(bits);
+    int length = 0;
+    if (view == BITS_PLAIN && bits->width < 64)
+    {
+        char expanded[64];
+        kernels->expandLimb(words[0], expanded);
+        memcpy(dest, expanded + 64 - bits->width, bits->width);
+        length = bits->width;
+    }
+    else if (view == BITS_PLAIN)
+    {
+        for (int i = bits->width / 64 - 1; i >= 0; i--)
+        {
+            kernels->expandLimb(words[i], dest + length);
+            length += 64;
+        }
+    }
+    else
+    {
+        const char hexDigits[] = "0123456789ABCDEF";
+        for (int i = bits->width / CHAR_BIT - 1; i >= 0; i--)
+        {
+            unsigned char value = (words[i / 8] >> (i % 8 * CHAR_BIT)) & 0xFF;
+            if (view == BITS_HEX)
+            {
+                *(dest + length++) = hexDigits[value >> 4];
+                *(dest + length++) = hexDigits[value & 0xF];
+                continue;
+            }
+            if (length > 0)
+            {
+                *(dest + length++) = ' ';
+            }
+            memcpy(dest + length, byteExpansion.bits[value], 4);
+            *(dest + length + 4) = ' ';
+            memcpy(dest + length + 5, byteExpansion.bits[value] + 4, 4);
+            length += 9;
+        }
+    }
+    *(dest + length) = '\0';
+    return length;
+}
+
+// Strips the sign of a lane and returns its digit count, or 0 if the lane
+// is empty, longer than capacity or has no valid radix.
+int prepareLane(const char src[], short radix, int capacity, const char **digits, bool *isNegative)
+{
+    *digits = src;
+    *isNegative = *src == '-';
+    if (*isNegative)
+    {
+        (*digits)++;
+    }
+    int length = 0;
+    while (length <= capacity && *(*digits + length) != '\0')
+    {
+        length++;
+    }
+    if (length > capacity || radix < 2 || radix > 36)
+    {
+        return 0;
+    }
+    return length;
+}
+
+void setLaneValue(ExactValue *value, unsigned long long magnitude, bool isNegative)
+{
+    value->magnitude.limbs[0] = magnitude;
+    value->magnitudeLimbs = 1;
+    value->exceedsMagnitude = false;
+    value->isNegative = isNegative;
+    value->hasFraction = false;
+    value->approximate = magnitude;
+}
+
+// Runs the 64-bit kernel over the listed records; lanes that are too long,
+// hold a fraction, may overflow 64 bits or fail to decode are re-parsed
+// with parseExact.
+void parseLongLanes(const char *const src[], const short radixes[], const int indexes[], int count,
+                    ExactValue values[], bool valid[])
+{
+    for (int first = 0; first < count; first += parseLaneCount)
+    {
+        unsigned char columns[laneDigitsCapacity * parseLaneCount];
+        memset(columns, '0', sizeof(columns));
+        LaneBytes radix;
+        bool isNegative[parseLaneCount];
+        bool isEligible[parseLaneCount];
+        int columnCount = 1;
+
+        for (int lane = 0; lane < parseLaneCount; lane++)
+        {
+            radix[lane] = 10;
+            isNegative[lane] = false;
+            isEligible[lane] = false;
+            if (first + lane >= count)
+            {
+                continue;
+            }
+
+            int index = indexes[first + lane];
+            const char *digits;
+            int length = prepareLane(src[index], radixes[index], laneDigitsCapacity, &digits, &isNegative[lane]);
+            if (length == 0)
+            {
+                continue;
+            }
+
+            isEligible[lane] = true;
+            radix[lane] = radixes[index];
+            for (int i = 0; i < length; i++)
+            {
+                columns[(laneDigitsCapacity - length + i) * parseLaneCount + lane] = *(digits + i);
+            }
+            if (length > columnCount)
+            {
+                columnCount = length;
+            }
+        }
+
+        LaneVector magnitude;
+        LaneBytes invalid;
+        LaneVector overflow;
+        kernels->parseLanes(columns + (laneDigitsCapacity - columnCount) * parseLaneCount, columnCount, &radix,
+                        &magnitude, &invalid, &overflow);
+
+        for (int lane = 0; lane < parseLaneCount && first + lane < count; lane++)
+        {
+            int index = indexes[first + lane];
+            if (!isEligible[lane] || invalid[lane] != 0 || overflow[lane] != 0)
+            {
+                valid[index] = parseExact(src[index], radixes[index], false, &values[index]);
+                continue;
+            }
+            setLaneValue(&values[index], magnitude[lane], isNegative[lane]);
+            valid[index] = true;
+        }
+    }
+}
+
+// Numbers short enough to fit 32 bits go through the 32-bit kernel and are
+// widened on the way out; all others are queued for parseLongLanes, which
+// runs once the queue fills whole groups, so results always match
+// parseExact.
+void parseExactBatch(const char *const src[], const short radixes[], int count, ExactValue values[], bool valid[])
+{
+    int longIndexes[shortLaneCount + parseLaneCount];
+    int longCount = 0;
+    for (int first = 0; first < count; first += shortLaneCount)
+    {
+        unsigned char columns[shortDigitsCapacity * shortLaneCount];
+        memset(columns, '0', sizeof(columns));
+        ShortLaneBytes radix;
+        bool isNegative[shortLaneCount];
+        bool isEligible[shortLaneCount];
+        int columnCount = 1;
+
+        for (int lane = 0; lane < shortLaneCount; lane++)
+        {
+            radix[lane] = 10;
+            isNegative[lane] = false;
+            isEligible[lane] = false;
+            if (first + lane >= count)
+            {
+                continue;
+            }
+
+            short laneRadix = radixes[first + lane];
+            int capacity = laneRadix >= 2 && laneRadix <= 36 ? shortLaneDigits.digits[laneRadix] : 0;
+            const char *digits;
+            int length = prepareLane(src[first + lane], laneRadix, capacity, &digits, &isNegative[lane]);
+            if (length == 0)
+            {
+                continue;
+            }
+
+            isEligible[lane] = true;
+            radix[lane] = laneRadix;
+            for (int i = 0; i < length; i++)
+            {
+                columns[(shortDigitsCapacity - length + i) * shortLaneCount + lane] = *(digits + i);
+            }
+            if (length > columnCount)
+            {
+                columnCount = length;
+            }
+        }
+
+        ShortLaneVector magnitude;
+        ShortLaneBytes invalid;
+        kernels->parseShortLanes(columns + (shortDigitsCapacity - columnCount) * shortLaneCount, columnCount, &radix,
+                                 &magnitude, &invalid);
+
+        for (int lane = 0; lane < shortLaneCount && first + lane < count; lane++)
+        {
+            if (isEligible[lane] && invalid[lane] != 0)
+            {
+                valid[first + lane] = parseExact(src[first + lane], radixes[first + lane], false, &values[first + lane]);
+            }
+            else if (!isEligible[lane])
+            {
+                longIndexes[longCount++] = first + lane;
+            }
+            else
+            {
+                setLaneValue(&values[first + lane], magnitude[lane], isNegative[lane]);
+                valid[first + lane] = true;
+            }
+        }
+
+        int ready = longCount - longCount % parseLaneCount;
+        parseLongLanes(src, radixes, longIndexes, ready, values, valid);
+        memmove(longIndexes, longIndexes + ready, (longCount - ready) * sizeof(longIndexes[0]));
+        longCount -= ready;
+    }
+    parseLongLanes(src, radixes, longIndexes, longCount, values, valid);
+}
+
+void narrowWideValue(const ExactValue *value, short typeIndex, NarrowResult *result)
+{
+    int limbCount = varSize[typeIndex] / sizeof(unsigned long long);
+    bool exceeds = value->exceedsMagnitude || value->magnitudeLimbs > limbCount;
+    for (int i = 0; i < limbCount; i++)
+    {
+        result->bits.limbs[i] = i < value->magnitudeLimbs ? value->magnitude.limbs[i] : 0;
+    }
+
+    bool inRange = !exceeds;
+    if (isNegativeMap[typeIndex] && (result->bits.limbs[limbCount - 1] >> 63) != 0)
+    {
+        bool isMinimum = result->bits.limbs[limbCount - 1] == (1ULL << 63) && limbsIsZero(result->bits.limbs, limbCount - 1);
+        inRange = inRange && value->isNegative && isMinimum;
+    }
+    else if (!isNegativeMap[typeIndex] && value->isNegative && !limbsIsZero(result->bits.limbs, limbCount))
+    {
+        inRange = false;
+    }
+
+    if (value->isNegative)
+    {
+        limbsNegate(result->bits.limbs, limbCount);
+    }
+    if (!inRange)
+    {
+        result->flags |= NARROW_WRAPPED;
+    }
+    if (value->hasFraction)
+    {
+        result->flags |= NARROW_TRUNCATED;
+    }
+}
+
+void narrowValue(const ExactValue *value, short typeIndex, NarrowResult *result)
+{
+    result->bits.word = 0;
+    result->bits.width = varSize[typeIndex] * CHAR_BIT;
+    result->flags = 0;
+
+    if (isFloatMap[typeIndex])
+    {
+        long double exact = value->isNegative ? -value->approximate : value->approximate;
+        long double narrowed = 0;
+        if (varSize[typeIndex] == sizeof(float))
+        {
+            float typed = (float)exact;
+            memcpy(&result->bits.word, &typed, sizeof(typed));
+            narrowed = typed;
+        }
+        else
+        {
+            double typed = (double)exact;
+            memcpy(&result->bits.word, &typed, sizeof(typed));
+            narrowed = typed;
+        }
+        if (std::isinf(narrowed))
+        {
+            result->flags |= NARROW_OVERFLOWED;
+        }
+        else if (narrowed != exact)
+        {
+            result->flags |= NARROW_ROUNDED;
+        }
+        return;
+    }
+
+    int width = varSize[typeIndex] * CHAR_BIT;
+    if (width > 64)
+    {
+        narrowWideValue(value, typeIndex, result);
+        return;
+    }
+
+    unsigned long long magnitude = value->magnitude.limbs[0];
+    unsigned long long mask = width >= 64 ? ULLONG_MAX : (1ULL << width) - 1;
+    bool inRange = !value->exceedsMagnitude && value->magnitudeLimbs == 1
+                   && narrowFits(magnitude, value->isNegative, typeIndex);
+
+    result->bits.word = (value->isNegative ? 0ULL - magnitude : magnitude) & mask;
+    if (!inRange)
+    {
+        result->flags |= NARROW_WRAPPED;
+    }
+    if (value->hasFraction)
+    {
+        result->flags |= NARROW_TRUNCATED;
+    }
+}
+
+void limbsToDecimal(const unsigned long long limbs[], int count, bool isSigned, char dest[])
+{
+    unsigned long long remaining[wideLimbsMax];
+    memcpy(remaining, limbs, count * sizeof(limbs[0]));
+    bool negative = isSigned && (remaining[count - 1] >> 63) != 0;
+    if (negative)
+    {
+        limbsNegate(remaining, count);
+    }
+
+    char reversed[decimalCapacity];
+    int length = 0;
+    while (true)
+    {
+        unsigned long long chunk = limbsDivide(remaining, count, 10000000000000000000ULL);
+        bool isLast = limbsIsZero(remaining, count);
+        for (int i = 0; i < 19; i++)
+        {
+            reversed[length++] = '0' + chunk % 10;
+            chunk /= 10;
+            if (isLast && chunk == 0)
+            {
+                break;
+            }
+        }
+        if (isLast)
+        {
+            break;
+        }
+    }
+
+    int position = 0;
+    if (negative)
+    {
+        *(dest + position++) = '-';
+    }
+    while (length > 0)
+    {
+        *(dest + position++) = reversed[--length];
+    }
+    *(dest + position) = '\0';
+}
+
+void formatNarrowed(short typeIndex, const NarrowResult *result, char decimalDest[])
+{
+    int binaryLength = varSize[typeIndex] * CHAR_BIT;
+    unsigned long long sys = result->bits.word;
+    if (binaryLength > 64)
+    {
+        limbsToDecimal(result->bits.limbs, binaryLength / 64, isNegativeMap[typeIndex], decimalDest);
+    }
+    else
+    {
+        std::stringstream ioStream;
+
+        ioStream.precision(16);
+
+        if (isFloatMap[typeIndex] && varSize[typeIndex] == sizeof(float))
+        {
+            float typed = 0;
+            memcpy(&typed, &sys, sizeof(typed));
+            ioStream << typed;
+        }
+        else if (isFloatMap[typeIndex])
+        {
+            double typed = 0;
+            memcpy(&typed, &sys, sizeof(typed));
+            ioStream << typed;
+        }
+        else if (isNegativeMap[typeIndex] && binaryLength < 64 && ((sys >> (binaryLength - 1)) & 0x1) == 1)
+        {
+            ioStream << (long long)(sys | (ULLONG_MAX << binaryLength));
+        }
+        else if (isNegativeMap[typeIndex])
+        {
+            ioStream << (long long)sys;
+        }
+        else
+        {
+            ioStream << sys;
+        }
+
+        ioStream >> decimalDest;
+    }
+}
+
+void describeNarrowFlags(int flags, char dest[])
+{
+    const char *names[] = {"wrap", "trunc", "round", "inf"};
+    int length = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        if ((flags >> i) & 0x1)
+        {
+            if (length > 0)
+            {
+                *(dest + length++) = '+';
+            }
+            for (int j = 0; names[i][j] != '\0'; j++)
+            {
+                *(dest + length++) = names[i][j];
+            }
+        }
+    }
+    if (length == 0)
+    {
+        *(dest + length++) = 'o';
+        *(dest + length++) = 'k';
+    }
+    *(dest + length) = '\0';
+}
+
+void printLabel(char label[], int x, int y)
+{
+    for (int i = 0; label[i] != '\0'; i++)
+    {
+        moveCursor(i + x, y);
+        putchar(label[i]);
+    }
+}
+
+void promptDataType()
+{
+    std::system("clear");
+    char label0[] = { 'S', 'e', 'l', 'e', 'c', 't', ' ', 'd', 'a', 't', 'a', ' ', 't', 'y', 'p', 'e', ':', '\0'};
+    printLabel(label0, 0, 0);
+    char label1[] = {'1', ':', ' ', 'c', 'h', 'a', 'r', '\0'};
+    printLabel(label1, 2, 2);
+    char label2[] = {'2', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'c', 'h', 'a', 'r', '\0'};
+    printLabel(label2, 2, 3);
+    char label3[] = {'3', ':', ' ', 's', 'h', 'o', 'r', 't', '\0'};
+    printLabel(label3, 2, 4);
+    char label4[] = {'4', ':', ' ', 's', 'h', 'o', 'r', 't', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label4, 2, 5);
+    char label5[] = {'5', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 's', 'h', 'o', 'r', 't', '\0'};
+    printLabel(label5, 2, 6);
+    char label6[] = {'6', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 's', 'h', 'o', 'r', 't', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label6, 2, 7);
+    char label7[] = {'7', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 's', 'h', 'o', 'r', 't', '\0'};
+    printLabel(label7, 2, 8);
+    char label8[] = {'8', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 's', 'h', 'o', 'r', 't', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label8, 2, 9);
+    char label9[] = {'9', ':', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label9, 2, 10);
+    char label10[] = {'1', '0', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label10, 2, 11);
+    char label11[] = {'1', '1', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label11, 2, 12);
+    char label12[] = {'1', '2', ':', ' ', 'l', 'o', 'n', 'g', '\0'};
+    printLabel(label12, 2, 13);
+    char label13[] = {'1', '3', ':', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label13, 2, 14);
+    char label14[] = {'1', '4', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', '\0'};
+    printLabel(label14, 20, 2);
+    char label15[] = {'1', '5', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label15, 20, 3);
+    char label16[] = {'1', '6', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', '\0'};
+    printLabel(label16, 20, 4);
+    char label17[] = {'1', '7', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label17, 20, 5);
+    char label18[] = {'1', '8', ':', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', '\0'};
+    printLabel(label18, 20, 6);
+    char label19[] = {'1', '9', ':', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label19, 20, 7);
+    char label20[] = {'2', '0', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', '\0'};
+    printLabel(label20, 20, 8);
+    char label21[] = {'2', '1', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label21, 20, 9);
+    char label22[] = {'2', '2', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', '\0'};
+    printLabel(label22, 20, 10);
+    char label23[] = {'2', '3', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
+    printLabel(label23, 20, 11);
+    char label24[] = {'2', '4', ':', ' ', 'f', 'l', 'o', 'a', 't', '\0'};
+    printLabel(label24, 20, 12);
+    char label25[] = {'2', '5', ':', ' ', 'd', 'o', 'u', 'b', 'l', 'e', '\0'};
+    printLabel(label25, 20, 13);
+    char label26[] = {'2', '6', ':', ' ', 'i', 'n', 't', '2', '5', '6', '\0'};
+    printLabel(label26, 46, 2);
+    char label27[] = {'2', '7', ':', ' ', 'u', 'i', 'n', 't', '2', '5', '6', '\0'};
+    printLabel(label27, 46, 3);
+    char label28[] = {'2', '8', ':', ' ', 'i', 'n', 't', '5', '1', '2', '\0'};
+    printLabel(label28, 46, 4);
+    char label29[] = {'2', '9', ':', ' ', 'u', 'i', 'n', 't', '5', '1', '2', '\0'};
+    printLabel(label29, 46, 5);
+    char label30[] = {'3', '0', ':', ' ', 'i', 'n', 't', '1', '0', '2', '4', '\0'};
+    printLabel(label30, 46, 6);
+    char label31[] = {'3', '1', ':', ' ', 'u', 'i', 'n', 't', '1', '0', '2', '4', '\0'};
+    printLabel(label31, 46, 7);
+
+    char label32[] = {'E', 'n', 't', 'e', 'r', ' ', 't', 'h', 'e', ' ', 'd', 'a', 't', 'a', ' ', 't', 'y', 'p', 'e', ':', ' ', '\0'};
+    printLabel(label32, 2, 16);
+
+    dataTypeIndex = rangeInput(2, 17, 1, dataTypeCount, true) - 1;
+
+    char emptyString[] = {' ',' ',' ',' ',' ',' ',' ',' ',' ', ' ', ' ', ' ', ' ', '\0'};
+    printLabel(emptyString, 2, 17);
+
+    mayBeNegative = isNegativeMap[dataTypeIndex];
+    mayBeFloat = isFloatMap[dataTypeIndex];
+    step = 1;
+}
+
+char decimal[10000] = {'\0'};
+unsigned long long binaryLimbs[wideLimbsMax] = {0};
+PackedBits binary = {0, binaryLimbs, 0};
+
+void prompt()
+{
+    std::system("clear");
+
+    moveCursor(0, 10);
+
+    changeRadix(input, decimal, &binary);
+    char label1[] = {'I', 'n', 'p', 'u', 't', ' ', 'n', 'u', 'm', 'b', 'e', 'r', ':', ' ', '\0'};
+    printLabel(label1, 0, 1);
+
+    for (int i = 0; input[i] != '\0'; i++)
+    {
+        moveCursor(i + 16, 1);
+        putchar(input[i]);
+    }
+    if (isNegative && inputLength > 0)
+    {
+        moveCursor(15, 1);
+        putchar('-');
+    }
+    moveCursor(0, 5);
+    std::cout << "Available symbols:";
+    for (int i = 0; i < base; i++)
+    {
+        moveCursor((i + 2) * 2, 6);
+        if (i < 10)
+        {
+            putchar(i + '0');
+        }
+        else
+        {
+            putchar(i - 10 + 'A');
+        }
+    }
+    if (mayBeNegative)
+    {
+        moveCursor(2, 6);
+        putchar('-');
+    }
+    if (mayBeFloat)
+    {
+        moveCursor(0, 6);
+        putchar('.');
+    }
+    moveCursor(0, 7);
+    std::cout << "Input number base: " << base << std::flush;
+    moveCursor(0, 8);
+    std::cout << "Using data type: " << dataTypeNames[dataTypeIndex] << std::flush;
+
+    moveCursor(0, 27);
+    std::cout << "Use Tab to open previous (base input) screen";
+    moveCursor(0, 28);
+    std::cout << "Use Enter to restart/exit program";
+    moveCursor(0, 10);
+
+
+    moveCursor(16 + inputLength, 1);
+}
+
+void printWrapped(const char text[], int x, int y, int width)
+{
+    int length = strlen(text);
+    for (int i = 0; i < length; i += width)
+    {
+        moveCursor(x, y + i / width);
+        fwrite(text + i, 1, length - i < width ? length - i : width, stdout);
+    }
+}
+
+// Wide types do not fit the input screen, so their result gets its own
+// screen with the decimal and binary text wrapped at 64 characters (eight
+// nibble-grouped bytes, 80 characters, per row).
+void renderWideResult()
+{
+    char binaryText[binaryCapacity];
+    renderBits(&binary, binaryView, binaryText);
+
+    std::system("clear");
+    moveCursor(0, 0);
+    std::cout << "Input number: " << (isNegative ? "-" : "") << input << " (base " << base << ")";
+    moveCursor(0, 1);
+    std::cout << "Using data type: " << dataTypeNames[dataTypeIndex] << std::flush;
+
+    moveCursor(0, 3);
+    std::cout << "Decimal:" << std::flush;
+    printWrapped(decimal, 16, 3, 64);
+    moveCursor(0, 9);
+    std::cout << "Binary:" << std::flush;
+    printWrapped(binaryText, 16, 9, binaryView == BITS_NIBBLES ? 80 : 64);
+
+    moveCursor(0, 28);
+    std::cout << "Use Enter to restart/exit program";
+    moveCursor(0, 29);
+    std::cout << "Use A to compare all data types";
+    moveCursor(0, 30);
+    std::cout << "Use V to switch binary view (bits/nibbles/hex)" << std::flush;
+}
+
+void renderResult() {
+    if (varSize[dataTypeIndex] > (short)sizeof(unsigned long long))
+    {
+        renderWideResult();
+        return;
+    }
+
+    char label2[] = {'D', 'e', 'c', 'i', 'm', 'a', 'l', ':', ' ', '\0'};
+    printLabel(label2, 0, 2);
+    char label3[] = {'B', 'i', 'n', 'a', 'r', 'y', ':', ' ', '\0'};
+    printLabel(label3, 0, 3);
+
+    char binaryText[binaryCapacity];
+    renderBits(&binary, binaryView, binaryText);
+
+    printLabel(binaryText, 16, 3);
+
+    printLabel(decimal, 16, 2);
+
+    moveCursor(0, 29);
+    std::cout << "Use A to compare all data types";
+    moveCursor(0, 30);
+    std::cout << "Use V to switch binary view (bits/nibbles/hex)" << std::flush;
+}
+
+void renderAllTypes()
+{
+    std::system("clear");
+
+    ExactValue value;
+    parseExact(input, base, isNegative, &value);
+
+    moveCursor(0, 0);
+    std::cout << "Input number: " << (isNegative ? "-" : "") << input << " (base " << base << ")";
+    moveCursor(0, 2);
+    std::cout << "Data type";
+    moveCursor(24, 2);
+    std::cout << "Decimal";
+    moveCursor(50, 2);
+    std::cout << "Flags";
+    moveCursor(62, 2);
+    std::cout << "Binary";
+
+    char typedDecimal[decimalCapacity] = {'\0'};
+    char typedBinary[binaryCapacity] = {'\0'};
+    char flags[32] = {'\0'};
+    unsigned long long limbs[wideLimbsMax];
+    for (short i = 0; i < dataTypeCount; i++)
+    {
+        NarrowResult result;
+        result.bits.limbs = limbs;
+        narrowValue(&value, i, &result);
+        formatNarrowed(i, &result, typedDecimal);
+        renderBits(&result.bits, binaryView, typedBinary);
+        describeNarrowFlags(result.flags, flags);
+
+        moveCursor(0, 3 + i);
+        std::cout << dataTypeNames[i];
+        int decimalLength = strlen(typedDecimal);
+        int binaryLength = strlen(typedBinary);
+        moveCursor(24, 3 + i);
+        if (decimalLength > 24)
+        {
+            std::cout << std::string(typedDecimal, 21) << "...";
+        }
+        else
+        {
+            std::cout << typedDecimal;
+        }
+        moveCursor(50, 3 + i);
+        std::cout << flags;
+        moveCursor(62, 3 + i);
+        if (binaryLength > 64)
+        {
+            std::cout << "..." << typedBinary + binaryLength - 64;
+        }
+        else
+        {
+            std::cout << typedBinary;
+        }
+    }
+
+    moveCursor(0, 4 + dataTypeCount);
+    std::cout << "Press any key to return" << std::flush;
+}
+
+void getBase()
+{
+    std::system("clear");
+    char label[] = {'I', 'n', 'p', 'u', 't', ' ', 'b', 'a', 's', 'e', ':', ' ', '\0'};
+    printLabel(label, 0, 0);
+    moveCursor(0, 3);
+    std::cout << "Use Tab to open previous screen";
+    base = rangeInput(13, 0, 2, 36, false);
+    if (base == -1)
+    {
+        step = 0;
+        return;
+    }
+    step = 2;
+    return;
+}
+
+enum OutputFormat
+{
+    OUTPUT_TEXT,
+    OUTPUT_CSV,
+    OUTPUT_JSON_LINES,
+    OUTPUT_BINARY,
+};
+
+OutputFormat outputFormat = OUTPUT_TEXT;
+
+const int recordDigitsCapacity = 256;
+const int outputRecordCapacity = 4096;
+const int outputBufferSize = 1 << 16;
+const int outputBufferCount = 4;
+
+bool writeAll(int fd, iovec vectors[], int count)
+{
+    while (count > 0)
+    {
+        ssize_t written = writev(fd, vectors, count);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return false;
+        }
+        while (count > 0 && (size_t)written >= vectors->iov_len)
+        {
+            written -= vectors->iov_len;
+            vectors++;
+            count--;
+        }
+        if (count > 0)
+        {
+            vectors->iov_base = (char *)vectors->iov_base + written;
+            vectors->iov_len -= written;
+        }
+    }
+    return true;
+}
+
+int appendText(char dest[], int length, const char text[])
+{
+    for (int i = 0; text[i] != '\0'; i++)
+    {
+        dest[length++] = text[i];
+    }
+    return length;
+}
+
+int appendCsvField(char dest[], int length, const char field[])
+{
+    bool needsQuotes = false;
+    for (int i = 0; field[i] != '\0'; i++)
+    {
+        if (field[i] == ',' || field[i] == '"' || field[i] == '\r')
+        {
+            needsQuotes = true;
+        }
+    }
+    if (!needsQuotes)
+    {
+        return appendText(dest, length, field);
+    }
+    dest[length++] = '"';
+    for (int i = 0; field[i] != '\0'; i++)
+    {
+        if (field[i] == '"')
+        {
+            dest[length++] = '"';
+        }
+        dest[length++] = field[i];
+    }
+    dest[length++] = '"';
+    return length;
+}
+
+int appendJsonString(char dest[], int length, const char key[], const char value[])
+{
+    length = appendText(dest, length, key);
+    dest[length++] = '"';
+    for (int i = 0; value[i] != '\0'; i++)
+    {
+        unsigned char symbol = value[i];
+        if (symbol == '"' || symbol == '\\')
+        {
+            dest[length++] = '\\';
+            dest[length++] = symbol;
+        }
+        else if (symbol < 0x20)
+        {
+            length += snprintf(dest + length, 7, "\\u%04x", symbol);
+        }
+        else
+        {
+            dest[length++] = symbol;
+        }
+    }
+    dest[length++] = '"';
+    return length;
+}
+
+int formatHeader(OutputFormat format, char dest[])
+{
+    if (format != OUTPUT_CSV)
+    {
+        return 0;
+    }
+    return appendText(dest, 0, "type,base,input,decimal,binary,flags\n");
+}
+
+// Binary records are packed little-endian: u16 record length, u8 type index
+// (0xFF if unknown), u8 base, u8 flags (0x80 = invalid), u8 value bytes,
+// u8 name length, u8 format version, u16 decimal length, u16 input length, then
+// the name, input and decimal bytes and finally the value bytes, least
+// significant first. Version 2 added the decimal length for the wide types.
+const int binaryRecordVersion = 2;
+
+int formatBinaryRecord(short typeIndex, short base, const char input[], const NarrowResult *result,
+                       const char typeName[], const char typedDecimal[], char dest[])
+{
+    int nameLength = strlen(typeName);
+    int inputLength = strlen(input);
+    int decimalLength = strlen(typedDecimal);
+    int valueBytes = result != NULL ? varSize[typeIndex] : 0;
+    const unsigned long long *words = result != NULL ? packedWords(&result->bits) : NULL;
+
+    int length = 12;
+    memcpy(dest + length, typeName, nameLength);
+    length += nameLength;
+    memcpy(dest + length, input, inputLength);
+    length += inputLength;
+    memcpy(dest + length, typedDecimal, decimalLength);
+    length += decimalLength;
+    for (int i = 0; i < valueBytes; i++)
+    {
+        dest[length++] = (words[i / 8] >> (i % 8 * CHAR_BIT)) & 0xFF;
+    }
+
+    dest[0] = length & 0xFF;
+    dest[1] = (length >> 8) & 0xFF;
+    dest[2] = typeIndex >= 0 && typeIndex < dataTypeCount ? typeIndex : 0xFF;
+    dest[3] = base;
+    dest[4] = result != NULL ? result->flags : 0x80;
+    dest[5] = valueBytes;
+    dest[6] = nameLength;
+    dest[7] = binaryRecordVersion;
+    dest[8] = decimalLength & 0xFF;
+    dest[9] = (decimalLength >> 8) & 0xFF;
+    dest[10] = inputLength & 0xFF;
+    dest[11] = (inputLength >> 8) & 0xFF;
+    return length;
+}
+
+// A NULL result marks a record whose input could not be converted.
+int formatRecord(OutputFormat format, short typeIndex, short base, const char input[], const NarrowResult *result, char dest[])
+{
+    char typedDecimal[decimalCapacity] = {'\0'};
+    char typedBinary[binaryCapacity] = {'\0'};
+    char flags[32] = {'\0'};
+    char radix[8] = {'\0'};
+    const char *typeName = typeIndex >= 0 && typeIndex < dataTypeCount ? dataTypeNames[typeIndex].c_str() : "?";
+
+    if (result != NULL)
+    {
+        formatNarrowed(typeIndex, result, typedDecimal);
+        if (format != OUTPUT_BINARY)
+        {
+            renderBits(&result->bits, binaryView, typedBinary);
+        }
+        describeNarrowFlags(result->flags, flags);
+    }
+    else
+    {
+        strcpy(typedDecimal, "invalid");
+    }
+
+    if (format == OUTPUT_BINARY)
+    {
+        return formatBinaryRecord(typeIndex, base, input, result, typeName, typedDecimal, dest);
+    }
+
+    snprintf(radix, sizeof(radix), "%d", base);
+    int length = 0;
+    if (format == OUTPUT_CSV)
+    {
+        length = appendCsvField(dest, length, typeName);
+        dest[length++] = ',';
+        length = appendText(dest, length, radix);
+        dest[length++] = ',';
+        length = appendCsvField(dest, length, input);
+        dest[length++] = ',';
+        length = appendText(dest, length, typedDecimal);
+        dest[length++] = ',';
+        length = appendText(dest, length, typedBinary);
+        dest[length++] = ',';
+        length = appendText(dest, length, flags);
+    }
+    else if (format == OUTPUT_JSON_LINES)
+    {
+        length = appendJsonString(dest, length, "{\"type\":", typeName);
+        length = appendText(dest, length, ",\"base\":");
+        length = appendText(dest, length, radix);
+        length = appendJsonString(dest, length, ",\"input\":", input);
+        length = appendJsonString(dest, length, ",\"decimal\":", typedDecimal);
+        length = appendJsonString(dest, length, ",\"binary\":", typedBinary);
+        length = appendJsonString(dest, length, ",\"flags\":", flags);
+        dest[length++] = '}';
+    }
+    else
+    {
+        length = appendText(dest, length, typeName);
+        dest[length++] = '\t';
+        length = appendText(dest, length, radix);
+        dest[length++] = '\t';
+        length = appendText(dest, length, input);
+        dest[length++] = '\t';
+        length = appendText(dest, length, typedDecimal);
+        dest[length++] = '\t';
+        length = appendText(dest, length, typedBinary);
+        dest[length++] = '\t';
+        length = appendText(dest, length, flags);
+    }
+    dest[length++] = '\n';
+    return length;
+}
+
+struct RecordWriter
+{
+    int fd;
+    OutputFormat format;
+    int current;
+    int used[outputBufferCount];
+    char buffers[outputBufferCount][outputBufferSize];
+};
+
+void writerOpen(RecordWriter *writer, int fd, OutputFormat format)
+{
+    writer->fd = fd;
+    writer->format = format;
+    writer->current = 0;
+    for (int i = 0; i < outputBufferCount; i++)
+    {
+        writer->used[i] = 0;
+    }
+    writer->used[0] = formatHeader(format, writer->buffers[0]);
+}
+
+bool writerFlush(RecordWriter *writer)
+{
+    iovec vectors[outputBufferCount];
+    int count = 0;
+    for (int i = 0; i <= writer->current; i++)
+    {
+        if (writer->used[i] > 0)
+        {
+            vectors[count].iov_base = writer->buffers[i];
+            vectors[count].iov_len = writer->used[i];
+            count++;
+        }
+        writer->used[i] = 0;
+    }
+    writer->current = 0;
+    return writeAll(writer->fd, vectors, count);
+}
+
+bool writerAppend(RecordWriter *writer, short typeIndex, short base, const char input[], const NarrowResult *result)
+{
+    if (writer->used[writer->current] + outputRecordCapacity > outputBufferSize)
+    {
+        if (writer->current + 1 == outputBufferCount)
+        {
+            if (!writerFlush(writer))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            writer->current++;
+        }
+    }
+    char *dest = writer->buffers[writer->current] + writer->used[writer->current];
+    writer->used[writer->current] += formatRecord(writer->format, typeIndex, base, input, result, dest);
+    return true;
+}
+
+int runAllTypes(const char radixText[], const char number[])
+{
+    int radix = atoi(radixText);
+    ExactValue value;
+    if (radix < 2 || radix > 36 || strlen(number) >= recordDigitsCapacity || !parseExact(number, radix, false, &value))
+    {
+        std::cerr << "Invalid number " << number << " for base " << radixText << std::endl;
+        return 1;
+    }
+
+    static RecordWriter writer;
+    writerOpen(&writer, 1, outputFormat);
+    unsigned long long limbs[wideLimbsMax];
+    for (short i = 0; i < dataTypeCount; i++)
+    {
+        NarrowResult result;
+        result.bits.limbs = limbs;
+        narrowValue(&value, i, &result);
+        if (!writerAppend(&writer, i, radix, number, &result))
+        {
+            return 1;
+        }
+    }
+    return writerFlush(&writer) ? 0 : 1;
+}
+
+template <typename T, int capacity>
+struct SpscRing
+{
+    T slots[capacity];
+    std::atomic<unsigned> head;
+    std::atomic<unsigned> tail;
+
+    void reset()
+    {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    bool tryPush(T item)
+    {
+        unsigned currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) == capacity)
+        {
+            return false;
+        }
+        slots[currentTail % capacity] = item;
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T *item)
+    {
+        unsigned currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        *item = slots[currentHead % capacity];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+void waitIdle(int *spins)
+{
+    (*spins)++;
+    if (*spins < 64)
+    {
+        return;
+    }
+    if (*spins < 1024)
+    {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+template <typename T, int capacity>
+void ringPush(SpscRing<T, capacity> *ring, T item)
+{
+    int spins = 0;
+    while (!ring->tryPush(item))
+    {
+        waitIdle(&spins);
+    }
+}
+
+template <typename T, int capacity>
+T ringPop(SpscRing<T, capacity> *ring)
+{
+    int spins = 0;
+    T item;
+    while (!ring->tryPop(&item))
+    {
+        waitIdle(&spins);
+    }
+    return item;
+}
+
+const int streamBatchSize = 64;
+const int streamBatchCount = 8;
+const int streamLineCapacity = 512;
+const int streamWriteBatches = 8;
+
+struct StreamRecord
+{
+    short typeIndex;
+    short base;
+    bool isValid;
+    char digits[recordDigitsCapacity];
+    ExactValue value;
+    // Wide results are written over the magnitude limbs of value, which is
+    // not needed once it has been narrowed.
+    NarrowResult result;
+};
+
+struct StreamBatch
+{
+    int count;
+    bool isLast;
+    StreamRecord records[streamBatchSize];
+    int outputLength;
+    char output[streamBatchSize * outputRecordCapacity];
+};
+
+// Batches circulate free -> parse -> convert -> format -> write -> free, so
+// the fixed pool bounds memory and a slow writer stalls the reader.
+struct StreamPipeline
+{
+    StreamBatch batches[streamBatchCount];
+    SpscRing<int, streamBatchCount> freeRing;
+    SpscRing<int, streamBatchCount> parseRing;
+    SpscRing<int, streamBatchCount> convertRing;
+    SpscRing<int, streamBatchCount> formatRing;
+    SpscRing<int, streamBatchCount> writeRing;
+    std::atomic<int> writeError;
+};
+
+const char *readStreamNumber(const char *cursor, const char *end, short *number)
+{
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+    {
+        cursor++;
+    }
+    int value = 0;
+    int digits = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9' && digits < 4)
+    {
+        value = value * 10 + (*cursor - '0');
+        digits++;
+        cursor++;
+    }
+    *number = digits > 0 ? value : -1;
+    return cursor;
+}
+
+// Record lines are "<data type 1-31> <base> <number>", as in the interactive screens.
+void parseStreamLine(const char *line, int length, StreamRecord *record)
+{
+    const char *end = line + length;
+    short typeNumber = -1;
+    const char *cursor = readStreamNumber(line, end, &typeNumber);
+    cursor = readStreamNumber(cursor, end, &record->base);
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t'))
+    {
+        cursor++;
+    }
+
+    int digitsLength = 0;
+    while (cursor < end && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && digitsLength < recordDigitsCapacity - 1)
+    {
+        record->digits[digitsLength++] = *cursor++;
+    }
+    record->digits[digitsLength] = '\0';
+
+    record->typeIndex = typeNumber - 1;
+    record->isValid = digitsLength > 0
+            && record->typeIndex >= 0 && record->typeIndex < dataTypeCount
+            && record->base >= 2 && record->base <= 36;
+    if (digitsLength == recordDigitsCapacity - 1 && cursor < end && *cursor != ' ' && *cursor != '\t' && *cursor != '\r')
+    {
+        record->isValid = false;
+    }
+}
+
+bool isStreamInputPending(int fd)
+{
+    pollfd descriptor;
+    descriptor.fd = fd;
+    descriptor.events = POLLIN;
+    descriptor.revents = 0;
+    return poll(&descriptor, 1, 0) > 0;
+}
+
+void streamReader(StreamPipeline *pipeline, int fd)
+{
+    static char chunk[65536];
+    char line[streamLineCapacity];
+    int lineLength = 0;
+    bool lineOverflowed = false;
+
+    int batchIndex = ringPop(&pipeline->freeRing);
+    StreamBatch *batch = &pipeline->batches[batchIndex];
+    batch->count = 0;
+    batch->isLast = false;
+
+    while (pipeline->writeError.load(std::memory_order_relaxed) == 0)
+    {
+        ssize_t received = read(fd, chunk, sizeof(chunk));
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            break;
+        }
+        for (ssize_t i = 0; i < received; i++)
+        {
+            if (chunk[i] != '\n')
+            {
+                if (lineLength < streamLineCapacity)
+                {
+                    line[lineLength++] = chunk[i];
+                }
+                else
+                {
+                    lineOverflowed = true;
+                }
+                continue;
+            }
+            if (lineLength > 0)
+            {
+                StreamRecord *record = &batch->records[batch->count++];
+                parseStreamLine(line, lineLength, record);
+                if (lineOverflowed)
+                {
+                    record->isValid = false;
+                }
+            }
+            lineLength = 0;
+            lineOverflowed = false;
+
+            if (batch->count == streamBatchSize)
+            {
+                ringPush(&pipeline->parseRing, batchIndex);
+                batchIndex = ringPop(&pipeline->freeRing);
+                batch = &pipeline->batches[batchIndex];
+                batch->count = 0;
+                batch->isLast = false;
+            }
+        }
+        if (batch->count > 0 && !isStreamInputPending(fd))
+        {
+            ringPush(&pipeline->parseRing, batchIndex);
+            batchIndex = ringPop(&pipeline->freeRing);
+            batch = &pipeline->batches[batchIndex];
+            batch->count = 0;
+            batch->isLast = false;
+        }
+    }
+
+    if (lineLength > 0)
+    {
+        StreamRecord *record = &batch->records[batch->count++];
+        parseStreamLine(line, lineLength, record);
+        if (lineOverflowed)
+        {
+            record->isValid = false;
+        }
+    }
+    batch->isLast = true;
+    ringPush(&pipeline->parseRing, batchIndex);
+}
+
+void streamParser(StreamPipeline *pipeline)
+{
+    while (true)
+    {
+        int batchIndex = ringPop(&pipeline->parseRing);
+        StreamBatch *batch = &pipeline->batches[batchIndex];
+        const char *digits[streamBatchSize];
+        short radixes[streamBatchSize];
+        ExactValue values[streamBatchSize];
+        bool valid[streamBatchSize];
+        int count = 0;
+        for (int i = 0; i < batch->count; i++)
+        {
+            if (batch->records[i].isValid)
+            {
+                digits[count] = batch->records[i].digits;
+                radixes[count] = batch->records[i].base;
+                count++;
+            }
+        }
+
+        parseExactBatch(digits, radixes, count, values, valid);
+
+        count = 0;
+        for (int i = 0; i < batch->count; i++)
+        {
+            StreamRecord *record = &batch->records[i];
+            if (record->isValid)
+            {
+                record->value = values[count];
+                record->isValid = valid[count];
+                count++;
+            }
+        }
+        bool isLast = batch->isLast;
+        ringPush(&pipeline->convertRing, batchIndex);
+        if (isLast)
+        {
+            return;
+        }
+    }
+}
+
+void streamConverter(StreamPipeline *pipeline)
+{
+    while (true)
+    {
+        int batchIndex = ringPop(&pipeline->convertRing);
+        StreamBatch *batch = &pipeline->batches[batchIndex];
+        for (int i = 0; i < batch->count; i++)
+        {
+            StreamRecord *record = &batch->records[i];
+            if (record->isValid)
+            {
+                record->result.bits.limbs = record->value.magnitude.limbs;
+                narrowValue(&record->value, record->typeIndex, &record->result);
+            }
+        }
+        bool isLast = batch->isLast;
+        ringPush(&pipeline->formatRing, batchIndex);
+        if (isLast)
+        {
+            return;
+        }
+    }
+}
+
+void streamFormatter(StreamPipeline *pipeline)
+{
+    while (true)
+    {
+        int batchIndex = ringPop(&pipeline->formatRing);
+        StreamBatch *batch = &pipeline->batches[batchIndex];
+        int length = 0;
+        for (int i = 0; i < batch->count; i++)
+        {
+            StreamRecord *record = &batch->records[i];
+            const NarrowResult *result = record->isValid ? &record->result : NULL;
+            length += formatRecord(outputFormat, record->typeIndex, record->base, record->digits, result, batch->output + length);
+        }
+        batch->outputLength = length;
+        bool isLast = batch->isLast;
+        ringPush(&pipeline->writeRing, batchIndex);
+        if (isLast)
+        {
+            return;
+        }
+    }
+}
+
+// Drains every formatted batch that is already waiting and hands them to
+// the kernel in one writev call.
+void streamWriter(StreamPipeline *pipeline, int fd)
+{
+    int batchIndexes[streamWriteBatches];
+    iovec vectors[streamWriteBatches];
+    while (true)
+    {
+        int count = 0;
+        batchIndexes[count++] = ringPop(&pipeline->writeRing);
+        while (count < streamWriteBatches && !pipeline->batches[batchIndexes[count - 1]].isLast
+                && pipeline->writeRing.tryPop(&batchIndexes[count]))
+        {
+            count++;
+        }
+
+        int vectorCount = 0;
+        for (int i = 0; i < count; i++)
+        {
+            StreamBatch *batch = &pipeline->batches[batchIndexes[i]];
+            if (batch->outputLength > 0)
+            {
+                vectors[vectorCount].iov_base = batch->output;
+                vectors[vectorCount].iov_len = batch->outputLength;
+                vectorCount++;
+            }
+        }
+        // After a failed write the remaining batches are only recycled, so
+        // every stage can drain and the reader stops at its next read.
+        if (pipeline->writeError.load(std::memory_order_relaxed) == 0 && !writeAll(fd, vectors, vectorCount))
+        {
+            pipeline->writeError.store(errno != 0 ? errno : EIO, std::memory_order_relaxed);
+        }
+
+        bool isLast = pipeline->batches[batchIndexes[count - 1]].isLast;
+        for (int i = 0; i < count; i++)
+        {
+            ringPush(&pipeline->freeRing, batchIndexes[i]);
+        }
+        if (isLast)
+        {
+            return;
+        }
+    }
+}
+
+int runStream()
+{
+    static StreamPipeline pipeline;
+    pipeline.freeRing.reset();
+    pipeline.parseRing.reset();
+    pipeline.convertRing.reset();
+    pipeline.formatRing.reset();
+    pipeline.writeRing.reset();
+    pipeline.writeError.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < streamBatchCount; i++)
+    {
+        pipeline.freeRing.tryPush(i);
+    }
+
+    char header[64];
+    iovec vector;
+    vector.iov_base = header;
+    vector.iov_len = formatHeader(outputFormat, header);
+    if (vector.iov_len > 0 && !writeAll(1, &vector, 1))
+    {
+        std::cerr << "Cannot write output: " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::thread reader(streamReader, &pipeline, 0);
+    std::thread parser(streamParser, &pipeline);
+    std::thread converter(streamConverter, &pipeline);
+    std::thread formatter(streamFormatter, &pipeline);
+    std::thread writer(streamWriter, &pipeline, 1);
+
+    reader.join();
+    parser.join();
+    converter.join();
+    formatter.join();
+    writer.join();
+
+    int writeError = pipeline.writeError.load(std::memory_order_relaxed);
+    if (writeError != 0)
+    {
+        std::cerr << "Cannot write output: " << strerror(writeError) << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+const uint32_t shmMagic = 0x4F45564D;
+// Version 2 widened ShmResponse::value to limbs for the wide types.
+const uint32_t shmLayoutVersion = 2;
+const uint32_t shmRingCapacity = 1024;
+const int shmIdleSpins = 4096;
+
+// Request and response layouts are shared with client processes, so they
+// only use fixed-width fields. Data type indexes are 0-based here.
+struct ShmRequest
+{
+    uint32_t id;
+    uint8_t dataTypeIndex;
+    uint8_t base;
+    uint16_t length;
+    char digits[recordDigitsCapacity];
+};
+
+// flags holds the NarrowFlags bits, or 0x80 if the request was invalid;
+// value holds the typed bits as limbs, least significant valueBytes bytes used.
+struct ShmResponse
+{
+    uint32_t id;
+    uint8_t dataTypeIndex;
+    uint8_t flags;
+    uint16_t decimalLength;
+    uint8_t valueBytes;
+    uint8_t reserved[7];
+    char decimal[decimalCapacity];
+    uint64_t value[wideLimbsMax];
+};
+
+// Each side sets its waiting word and sleeps in futex only after spinning
+// on an idle ring; the other side issues a wake only when that word is set.
+template <typename T>
+struct ShmRing
+{
+    alignas(64) std::atomic<uint32_t> head;
+    std::atomic<uint32_t> producerWaiting;
+    alignas(64) std::atomic<uint32_t> tail;
+    std::atomic<uint32_t> consumerWaiting;
+    alignas(64) T slots[shmRingCapacity];
+};
+
+struct ShmRegion
+{
+    std::atomic<uint32_t> magic;
+    std::atomic<uint32_t> version;
+    std::atomic<uint32_t> shutdown;
+    ShmRing<ShmRequest> requests;
+    ShmRing<ShmResponse> responses;
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "ring counters must be plain 32-bit words");
+static_assert(sizeof(ShmRequest) == 8 + recordDigitsCapacity, "ShmRequest layout must be packed");
+static_assert(sizeof(ShmResponse) == 16 + decimalCapacity + 8 * wideLimbsMax, "ShmResponse layout must be packed");
+
+void shmWait(std::atomic<uint32_t> *word, uint32_t observed, std::atomic<uint32_t> *waiting)
+{
+    waiting->store(1, std::memory_order_seq_cst);
+    if (word->load(std::memory_order_seq_cst) == observed)
     {
-        ioStream << decimalValue.type9;
+        timespec timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_nsec = 100 * 1000 * 1000;
+        syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, observed, &timeout, NULL, 0);
     }
-    else if (dataTypeIndex == 10)
+    waiting->store(0, std::memory_order_relaxed);
+}
+
+// The fence orders the caller's release store of word before the load of
+// waiting; without it the store can pass the load and a wake can be lost
+// against shmWait's store to waiting followed by its load of word.
+void shmWake(std::atomic<uint32_t> *word, std::atomic<uint32_t> *waiting)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting->load(std::memory_order_seq_cst) != 0)
     {
-        ioStream << decimalValue.type10;
+        syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, 1, NULL, NULL, 0);
     }
-    else if (dataTypeIndex == 11)
+}
+
+void shmPushResponse(ShmRegion *region, const ShmResponse *response)
+{
+    ShmRing<ShmResponse> *ring = &region->responses;
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    int spins = 0;
+    while (true)
     {
-        ioStream << decimalValue.type11;
+        uint32_t head = ring->head.load(std::memory_order_acquire);
+        if (tail - head < shmRingCapacity)
+        {
+            break;
+        }
+        if (region->shutdown.load(std::memory_order_relaxed) != 0)
+        {
+            return;
+        }
+        if (++spins < shmIdleSpins)
+        {
+            continue;
+        }
+        shmWait(&ring->head, head, &ring->producerWaiting);
     }
-    else if (dataTypeIndex == 12)
+    ring->slots[tail % shmRingCapacity] = *response;
+    ring->tail.store(tail + 1, std::memory_order_release);
+    shmWake(&ring->tail, &ring->consumerWaiting);
+}
+
+void shmConvert(ShmRegion *region, uint32_t head, uint32_t count)
+{
+    ShmRing<ShmRequest> *ring = &region->requests;
+    const char *digits[streamBatchSize] = {NULL};
+    short radixes[streamBatchSize] = {0};
+    ExactValue values[streamBatchSize];
+    bool valid[streamBatchSize];
+    char terminated[streamBatchSize][recordDigitsCapacity + 1];
+    for (uint32_t i = 0; i < count; i++)
     {
-        ioStream << decimalValue.type12;
+        const ShmRequest *request = &ring->slots[(head + i) % shmRingCapacity];
+        int length = request->length < recordDigitsCapacity ? request->length : recordDigitsCapacity;
+        memcpy(terminated[i], request->digits, length);
+        terminated[i][length] = '\0';
+        digits[i] = terminated[i];
+        radixes[i] = request->base;
     }
-    else if (dataTypeIndex == 13)
+
+    parseExactBatch(digits, radixes, count, values, valid);
+
+    for (uint32_t i = 0; i < count; i++)
     {
-        ioStream << decimalValue.type13;
+        const ShmRequest *request = &ring->slots[(head + i) % shmRingCapacity];
+        ShmResponse response;
+        memset(&response, 0, sizeof(response));
+        response.id = request->id;
+        response.dataTypeIndex = request->dataTypeIndex;
+        if (valid[i] && request->dataTypeIndex < dataTypeCount && request->base >= 2 && request->base <= 36
+                && request->length <= recordDigitsCapacity)
+        {
+            unsigned long long limbs[wideLimbsMax];
+            NarrowResult result;
+            result.bits.limbs = limbs;
+            narrowValue(&values[i], request->dataTypeIndex, &result);
+            formatNarrowed(request->dataTypeIndex, &result, response.decimal);
+            response.flags = result.flags;
+            response.valueBytes = varSize[request->dataTypeIndex];
+            response.decimalLength = strlen(response.decimal);
+            memcpy(response.value, packedWords(&result.bits), response.valueBytes);
+        }
+        else
+        {
+            response.flags = 0x80;
+        }
+        shmPushResponse(region, &response);
     }
-    else if (dataTypeIndex == 14)
+    ring->head.store(head + count, std::memory_order_release);
+    shmWake(&ring->head, &ring->producerWaiting);
+}
+
+// Maps the region; the converter creates it if needed, clients only open
+// an existing one.
+ShmRegion *shmMap(const char name[], bool create)
+{
+    int fd = shm_open(name, create ? O_RDWR | O_CREAT : O_RDWR, 0600);
+    if (fd < 0)
     {
-        ioStream << decimalValue.type14;
+        std::cerr << "Cannot open shared memory " << name << ": " << strerror(errno) << std::endl;
+        return NULL;
     }
-    else if (dataTypeIndex == 15)
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (status.st_size < (off_t)sizeof(ShmRegion)
+            && (!create || ftruncate(fd, sizeof(ShmRegion)) != 0)))
     {
-        ioStream << decimalValue.type15;
+        std::cerr << "Cannot size shared memory " << name << ": " << strerror(errno) << std::endl;
+        close(fd);
+        return NULL;
     }
-    else if (dataTypeIndex == 16)
+    void *mapping = mmap(NULL, sizeof(ShmRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
     {
-        ioStream << decimalValue.type16;
+        std::cerr << "Cannot map shared memory " << name << ": " << strerror(errno) << std::endl;
+        return NULL;
     }
-    else if (dataTypeIndex == 17)
+    return (ShmRegion *)mapping;
+}
+
+// The converter resets the region on start, so rings and the shutdown flag
+// left by an earlier converter are discarded; clients must attach after it
+// is up. Setting shutdown and waking the request tail stops it
+// (shmRequestShutdown), and a clean stop unlinks the region.
+int runSharedMemory(const char name[])
+{
+    ShmRegion *region = shmMap(name, true);
+    if (region == NULL)
     {
-        ioStream << decimalValue.type17;
+        return 1;
     }
-    else if (dataTypeIndex == 18)
+    region->magic.store(0, std::memory_order_relaxed);
+    memset((void *)region, 0, sizeof(ShmRegion));
+    region->version.store(shmLayoutVersion, std::memory_order_relaxed);
+    region->magic.store(shmMagic, std::memory_order_release);
+
+    ShmRing<ShmRequest> *ring = &region->requests;
+    int spins = 0;
+    while (true)
     {
-        ioStream << decimalValue.type18;
+        uint32_t head = ring->head.load(std::memory_order_relaxed);
+        uint32_t tail = ring->tail.load(std::memory_order_acquire);
+        if (head != tail)
+        {
+            uint32_t count = tail - head;
+            shmConvert(region, head, count < (uint32_t)streamBatchSize ? count : streamBatchSize);
+            spins = 0;
+            continue;
+        }
+        if (region->shutdown.load(std::memory_order_acquire) != 0)
+        {
+            break;
+        }
+        if (++spins < shmIdleSpins)
+        {
+            continue;
+        }
+        shmWait(&ring->tail, tail, &ring->consumerWaiting);
     }
-    else if (dataTypeIndex == 19)
+
+    munmap(region, sizeof(ShmRegion));
+    shm_unlink(name);
+    return 0;
+}
+
+// Client side of the protocol, for any process mapping the same region:
+//  1. map the region, wait until magic reads shmMagic and check that
+//     version equals shmLayoutVersion (shmAttach);
+//  2. fill requests.slots[tail % shmRingCapacity], store tail + 1 with
+//     release and call shmWake on the request tail (shmTrySubmit);
+//  3. read responses.slots from head up to tail, store the new head with
+//     release and call shmWake on the response head (shmTryReceive);
+//  4. when idle, call shmWait on the response tail with consumerWaiting;
+//  5. to stop the converter, store shutdown = 1 and wake the request tail;
+//     it unlinks the region on the way out.
+// Responses come back in request order.
+ShmRegion *shmAttach(const char name[])
+{
+    ShmRegion *region = shmMap(name, false);
+    if (region == NULL)
     {
-        ioStream << decimalValue.type19;
+        return NULL;
     }
-    else if (dataTypeIndex == 20)
+    for (int i = 0; i < 1000 && region->magic.load(std::memory_order_acquire) != shmMagic; i++)
     {
-        ioStream << decimalValue.type20;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
-    else if (dataTypeIndex == 21)
+    if (region->magic.load(std::memory_order_acquire) != shmMagic)
     {
-        ioStream << decimalValue.type21;
+        std::cerr << "Shared memory " << name << " has no converter" << std::endl;
+        munmap(region, sizeof(ShmRegion));
+        return NULL;
     }
-    else if (dataTypeIndex == 22)
+    if (region->version.load(std::memory_order_relaxed) != shmLayoutVersion)
     {
-        ioStream << decimalValue.type22;
+        std::cerr << "Shared memory " << name << " uses layout version "
+                  << region->version.load(std::memory_order_relaxed) << ", expected " << shmLayoutVersion << std::endl;
+        munmap(region, sizeof(ShmRegion));
+        return NULL;
     }
-    else if (dataTypeIndex == 23)
+    return region;
+}
+
+bool shmTrySubmit(ShmRegion *region, const ShmRequest *request)
+{
+    ShmRing<ShmRequest> *ring = &region->requests;
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    if (tail - ring->head.load(std::memory_order_acquire) == shmRingCapacity)
     {
-        ioStream << decimalValue.type23;
+        return false;
     }
-    else if (dataTypeIndex == 24)
+    ring->slots[tail % shmRingCapacity] = *request;
+    ring->tail.store(tail + 1, std::memory_order_release);
+    shmWake(&ring->tail, &ring->consumerWaiting);
+    return true;
+}
+
+bool shmTryReceive(ShmRegion *region, ShmResponse *response)
+{
+    ShmRing<ShmResponse> *ring = &region->responses;
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head == ring->tail.load(std::memory_order_acquire))
     {
-        ioStream << decimalValue.type24;
+        return false;
     }
+    *response = ring->slots[head % shmRingCapacity];
+    ring->head.store(head + 1, std::memory_order_release);
+    shmWake(&ring->head, &ring->producerWaiting);
+    return true;
+}
+
+void shmRequestShutdown(ShmRegion *region)
+{
+    region->shutdown.store(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, (uint32_t *)&region->requests.tail, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
 
-    ioStream >> decimalDest;
+struct ShmPending
+{
+    short typeIndex;
+    short base;
+    char digits[recordDigitsCapacity];
+};
 
-    int binaryLength = varSize[dataTypeIndex] * CHAR_BIT;
-    *(binaryDest + binaryLength + 1) = '\0';
-    for (int i = 0; i < binaryLength; i++)
+bool shmWriteResponse(RecordWriter *writer, const ShmPending *pending, const ShmResponse *response)
+{
+    if (response->flags == 0x80)
     {
-        *(binaryDest + binaryLength - i - 1) = ((decimalValue.sys >> i) & 0x1) == 1 ? '1' : '0';
+        return writerAppend(writer, pending->typeIndex, pending->base, pending->digits, NULL);
     }
+    unsigned long long limbs[wideLimbsMax];
+    NarrowResult result;
+    result.flags = response->flags;
+    result.bits.word = 0;
+    result.bits.limbs = limbs;
+    result.bits.width = response->valueBytes * CHAR_BIT;
+    memcpy(result.bits.width > 64 ? limbs : &result.bits.word, response->value, response->valueBytes);
+    return writerAppend(writer, pending->typeIndex, pending->base, pending->digits, &result);
 }
 
-void printLabel(char label[], int x, int y)
+// Reference client: sends "<data type> <base> <number>" lines from stdin
+// to a running converter and writes the responses like --stream does.
+int runSharedMemoryClient(const char name[])
 {
-    for (int i = 0; label[i] != '\0'; i++)
+    ShmRegion *region = shmAttach(name);
+    if (region == NULL)
     {
-        moveCursor(i + x, y);
-        putchar(label[i]);
+        return 1;
     }
-}
 
-void promptDataType()
-{
-    std::system("clear");
-    char label0[] = { 'S', 'e', 'l', 'e', 'c', 't', ' ', 'd', 'a', 't', 'a', ' ', 't', 'y', 'p', 'e', ':', '\0'};
-    printLabel(label0, 0, 0);
-    char label1[] = {'1', ':', ' ', 'c', 'h', 'a', 'r', '\0'};
-    printLabel(label1, 2, 2);
-    char label2[] = {'2', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'c', 'h', 'a', 'r', '\0'};
-    printLabel(label2, 2, 3);
-    char label3[] = {'3', ':', ' ', 's', 'h', 'o', 'r', 't', '\0'};
-    printLabel(label3, 2, 4);
-    char label4[] = {'4', ':', ' ', 's', 'h', 'o', 'r', 't', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label4, 2, 5);
-    char label5[] = {'5', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 's', 'h', 'o', 'r', 't', '\0'};
-    printLabel(label5, 2, 6);
-    char label6[] = {'6', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 's', 'h', 'o', 'r', 't', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label6, 2, 7);
-    char label7[] = {'7', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 's', 'h', 'o', 'r', 't', '\0'};
-    printLabel(label7, 2, 8);
-    char label8[] = {'8', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 's', 'h', 'o', 'r', 't', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label8, 2, 9);
-    char label9[] = {'9', ':', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label9, 2, 10);
-    char label10[] = {'1', '0', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label10, 2, 11);
-    char label11[] = {'1', '1', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label11, 2, 12);
-    char label12[] = {'1', '2', ':', ' ', 'l', 'o', 'n', 'g', '\0'};
-    printLabel(label12, 2, 13);
-    char label13[] = {'1', '3', ':', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label13, 2, 14);
-    char label14[] = {'1', '4', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', '\0'};
-    printLabel(label14, 20, 2);
-    char label15[] = {'1', '5', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label15, 20, 3);
-    char label16[] = {'1', '6', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', '\0'};
-    printLabel(label16, 20, 4);
-    char label17[] = {'1', '7', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label17, 20, 5);
-    char label18[] = {'1', '8', ':', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', '\0'};
-    printLabel(label18, 20, 6);
-    char label19[] = {'1', '9', ':', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label19, 20, 7);
-    char label20[] = {'2', '0', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', '\0'};
-    printLabel(label20, 20, 8);
-    char label21[] = {'2', '1', ':', ' ', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label21, 20, 9);
-    char label22[] = {'2', '2', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', '\0'};
-    printLabel(label22, 20, 10);
-    char label23[] = {'2', '3', ':', ' ', 'u', 'n', 's', 'i', 'g', 'n', 'e', 'd', ' ', 'l', 'o', 'n', 'g', ' ', 'l', 'o', 'n', 'g', ' ', 'i', 'n', 't', '\0'};
-    printLabel(label23, 20, 11);
-    char label24[] = {'2', '4', ':', ' ', 'f', 'l', 'o', 'a', 't', '\0'};
-    printLabel(label24, 20, 12);
-    char label25[] = {'2', '5', ':', ' ', 'd', 'o', 'u', 'b', 'l', 'e', '\0'};
-    printLabel(label25, 20, 13);
+    static ShmPending pending[2 * shmRingCapacity];
+    static RecordWriter writer;
+    writerOpen(&writer, 1, outputFormat);
+    char line[streamLineCapacity + 2];
+    StreamRecord record;
+    uint32_t sent = 0;
+    uint32_t received = 0;
+    bool isFinished = false;
+    bool isWritten = true;
+    ShmResponse response;
+    while (isWritten && (!isFinished || received != sent))
+    {
+        int spins = 0;
+        while (!isFinished && sent - received < 2 * shmRingCapacity)
+        {
+            if (fgets(line, sizeof(line), stdin) == NULL)
+            {
+                isFinished = true;
+                break;
+            }
+            // Like streamReader, an overlong line is one invalid record.
+            int length = strcspn(line, "\n");
+            bool lineOverflowed = length > streamLineCapacity;
+            if (line[length] != '\n')
+            {
+                int symbol;
+                while ((symbol = getchar()) != EOF && symbol != '\n')
+                {
+                    lineOverflowed = true;
+                }
+            }
+            if (length == 0)
+            {
+                continue;
+            }
+            parseStreamLine(line, lineOverflowed ? streamLineCapacity : length, &record);
+            if (lineOverflowed)
+            {
+                record.isValid = false;
+            }
 
-    char label30[] = {'E', 'n', 't', 'e', 'r', ' ', 't', 'h', 'e', ' ', 'd', 'a', 't', 'a', ' ', 't', 'y', 'p', 'e', ':', ' ', '\0'};
-    printLabel(label30, 2, 16);
+            ShmPending *slot = &pending[sent % (2 * shmRingCapacity)];
+            slot->typeIndex = record.typeIndex;
+            slot->base = record.base;
+            strcpy(slot->digits, record.digits);
 
-    dataTypeIndex = rangeInput(2, 17, 1, 25, true) - 1;
+            ShmRequest request;
+            memset(&request, 0, sizeof(request));
+            request.id = sent;
+            request.dataTypeIndex = record.isValid ? record.typeIndex : 0xFF;
+            request.base = record.base >= 0 && record.base <= 0xFF ? record.base : 0;
+            request.length = strlen(record.digits);
+            memcpy(request.digits, record.digits, request.length);
+            while (!shmTrySubmit(region, &request))
+            {
+                while (isWritten && shmTryReceive(region, &response))
+                {
+                    isWritten = shmWriteResponse(&writer, &pending[received++ % (2 * shmRingCapacity)], &response);
+                }
+                waitIdle(&spins);
+            }
+            sent++;
+        }
 
-    char emptyString[] = {' ',' ',' ',' ',' ',' ',' ',' ',' ', ' ', ' ', ' ', ' ', '\0'};
-    printLabel(emptyString, 2, 17);
+        bool hasResponse = false;
+        while (isWritten && shmTryReceive(region, &response))
+        {
+            isWritten = shmWriteResponse(&writer, &pending[received++ % (2 * shmRingCapacity)], &response);
+            hasResponse = true;
+        }
+        if (!hasResponse && received != sent)
+        {
+            ShmRing<ShmResponse> *ring = &region->responses;
+            uint32_t tail = ring->tail.load(std::memory_order_acquire);
+            if (tail == ring->head.load(std::memory_order_relaxed))
+            {
+                shmWait(&ring->tail, tail, &ring->consumerWaiting);
+            }
+        }
+    }
 
-    mayBeNegative = isNegativeMap[dataTypeIndex];
-    mayBeFloat = isFloatMap[dataTypeIndex];
-    step = 1;
+    munmap(region, sizeof(ShmRegion));
+    return isWritten && writerFlush(&writer) ? 0 : 1;
 }
 
-char decimal[10000] = {'\0'};
-char binary[10000] = {'\0'};
-
-void prompt()
+int stopSharedMemory(const char name[])
 {
-    std::system("clear");
-
-    moveCursor(0, 10);
-
-    changeRadix(input, decimal, binary);
-    char label1[] = {'I', 'n', 'p', 'u', 't', ' ', 'n', 'u', 'm', 'b', 'e', 'r', ':', ' ', '\0'};
-    printLabel(label1, 0, 1);
-
-    for (int i = 0; input[i] != '\0'; i++)
+    ShmRegion *region = shmAttach(name);
+    if (region == NULL)
     {
-        moveCursor(i + 16, 1);
-        putchar(input[i]);
+        return 1;
     }
-    if (isNegative && inputLength > 0)
+    shmRequestShutdown(region);
+    munmap(region, sizeof(ShmRegion));
+    return 0;
+}
+
+// Finds value in names and stores its index; used for the enum options.
+bool parseOption(const char value[], const char *const names[], int count, int *index)
+{
+    for (int j = 0; j < count; j++)
     {
-        moveCursor(15, 1);
-        putchar('-');
+        if (strcmp(value, names[j]) == 0)
+        {
+            *index = j;
+            return true;
+        }
     }
-    moveCursor(0, 5);
-    std::cout << "Available symbols:";
-    for (int i = 0; i < base; i++)
+    std::cerr << "Unknown option value " << value << std::endl;
+    return false;
+}
+
+int runHeadless(int argc, char *argv[])
+{
+    const char *formats[] = {"text", "csv", "jsonl", "binary"};
+    const char *views[] = {"bits", "nibbles", "hex"};
+    int i = 1;
+    while (i + 1 < argc)
     {
-        moveCursor((i + 2) * 2, 6);
-        if (i < 10)
+        int index = 0;
+        if (strcmp(argv[i], "--kernel") == 0)
         {
-            putchar(i + '0');
+            if (!selectKernels(argv[i + 1]))
+            {
+                std::cerr << "Kernel variant " << argv[i + 1] << " is unknown or not supported by this CPU" << std::endl;
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--format") == 0)
+        {
+            if (!parseOption(argv[i + 1], formats, 4, &index))
+            {
+                return 1;
+            }
+            outputFormat = (OutputFormat)index;
+        }
+        else if (strcmp(argv[i], "--binary-view") == 0)
+        {
+            if (!parseOption(argv[i + 1], views, 3, &index))
+            {
+                return 1;
+            }
+            binaryView = (BitsView)index;
         }
         else
         {
-            putchar(i - 10 + 'A');
+            break;
         }
+        i += 2;
     }
-    if (mayBeNegative)
+
+    if (argc - i == 3 && strcmp(argv[i], "--all") == 0)
     {
-        moveCursor(2, 6);
-        putchar('-');
+        return runAllTypes(argv[i + 1], argv[i + 2]);
     }
-    if (mayBeFloat)
+    if (argc - i == 1 && strcmp(argv[i], "--stream") == 0)
     {
-        moveCursor(0, 6);
-        putchar('.');
+        return runStream();
     }
-    moveCursor(0, 7);
-    std::cout << "Input number base: " << base << std::flush;
-    moveCursor(0, 8);
-    std::cout << "Using data type: " << dataTypeNames[dataTypeIndex] << std::flush;
-
-    moveCursor(0, 27);
-    std::cout << "Use Tab to open previous (base input) screen";
-    moveCursor(0, 28);
-    std::cout << "Use Enter to restart/exit program";
-    moveCursor(0, 10);
-
-
-    moveCursor(16 + inputLength, 1);
-}
-
-void renderResult() {
-    char label2[] = {'D', 'e', 'c', 'i', 'm', 'a', 'l', ':', ' ', '\0'};
-    printLabel(label2, 0, 2);
-    char label3[] = {'B', 'i', 'n', 'a', 'r', 'y', ':', ' ', '\0'};
-    printLabel(label3, 0, 3);
-
-    int binaryLength = 0;
-    while (binary[binaryLength] != '\0')
-        binaryLength++;
-
-
-    printLabel(binary, 16, 3);
-
-    printLabel(decimal, 16, 2);
-}
-
-void getBase()
-{
-    std::system("clear");
-    char label[] = {'I', 'n', 'p', 'u', 't', ' ', 'b', 'a', 's', 'e', ':', ' ', '\0'};
-    printLabel(label, 0, 0);
-    moveCursor(0, 3);
-    std::cout << "Use Tab to open previous screen";
-    base = rangeInput(13, 0, 2, 36, false);
-    if (base == -1)
+    if (argc - i == 2 && strcmp(argv[i], "--shm") == 0)
     {
-        step = 0;
-        return;
+        return runSharedMemory(argv[i + 1]);
     }
-    step = 2;
-    return;
+    if (argc - i == 2 && strcmp(argv[i], "--shm-client") == 0)
+    {
+        return runSharedMemoryClient(argv[i + 1]);
+    }
+    if (argc - i == 2 && strcmp(argv[i], "--shm-stop") == 0)
+    {
+        return stopSharedMemory(argv[i + 1]);
+    }
+    std::cerr << "Usage: " << argv[0] << " [--kernel avx512|avx2|sse4.2|baseline] [--format text|csv|jsonl|binary] [--binary-view bits|nibbles|hex] (--all BASE NUMBER | --stream | --shm NAME | --shm-client NAME | --shm-stop NAME)" << std::endl;
+    return 1;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+    selectKernels(NULL);
+
+    if (argc > 1)
+    {
+        return runHeadless(argc, argv);
+    }
 
     char inputSymbol = '0';
     int floatDelimeter = -1;
@@ -859,6 +3132,22 @@ int main()
                     return 0;
                 }
             }
+            else if (inputSymbol == 'a' || inputSymbol == 'A')
+            {
+                step = 4;
+            }
+            else if (inputSymbol == 'v' || inputSymbol == 'V')
+            {
+                binaryView = (BitsView)((binaryView + 1) % 3);
+                prompt();
+            }
+        }
+        else if (step == 4)
+        {
+            renderAllTypes();
+            getch();
+            prompt();
+            step = 3;
         }
     }
     return 0;